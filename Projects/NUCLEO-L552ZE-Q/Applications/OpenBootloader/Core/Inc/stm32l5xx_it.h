@@ -39,7 +39,10 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
 
-void SPI1_IRQHandler(void);
+void FLASH_IRQHandler(void);
+void USART3_IRQHandler(void);
+void DMA1_Channel2_IRQHandler(void);
+void FDCAN1_IT0_IRQHandler(void);
 void USB_FS_IRQHandler(void);
 
 #ifdef __cplusplus
@@ -21,6 +21,7 @@
 #include "interfaces_conf.h"
 #include "main.h"
 #include "app_openbootloader.h"
+#include "common_interface.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -104,7 +105,7 @@ static void SystemClock_Config(void)
   RCC_OscInitStruct.PLL.PLLM            = 1;
   RCC_OscInitStruct.PLL.PLLN            = 40;
   RCC_OscInitStruct.PLL.PLLP            = RCC_PLLP_DIV7;
-  RCC_OscInitStruct.PLL.PLLQ            = RCC_PLLQ_DIV8;
+  RCC_OscInitStruct.PLL.PLLQ            = RCC_PLLQ_DIV4;
   RCC_OscInitStruct.PLL.PLLR            = RCC_PLLR_DIV2;
   if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
   {
@@ -124,7 +125,7 @@ static void SystemClock_Config(void)
     Error_Handler();
   }
 
-  /* Select PLL1Q as source of FDCANx clock */
+  /* Select PLL1Q (40 MHz) as source of FDCANx clock */
   RCC_PeriphClkInit.PeriphClockSelection = RCC_PERIPHCLK_FDCAN;
   RCC_PeriphClkInit.FdcanClockSelection  = RCC_FDCANCLKSOURCE_PLL;
   HAL_RCCEx_PeriphCLKConfig(&RCC_PeriphClkInit);
@@ -149,14 +150,32 @@ static void SystemClock_Config(void)
   */
 void System_DeInit(void)
 {
+  uint32_t deadline = Common_StartTimeout(OPENBL_USART_TIMEOUT);
+
+  /* Let the USART send its last byte, the acknowledge of the Go command, unless the host holds CTS */
+  while ((LL_USART_IsEnabled(USARTx) != 0U) && (LL_USART_IsActiveFlag_TC(USARTx) == 0U)
+         && (Common_IsTimeoutElapsed(deadline) == RESET))
+  {
+  }
+
   USARTx_DeInit();
+  USARTx_RX_DMA_DeInit();
+  USARTx_TX_DMA_DeInit();
   I2Cx_DeInit();
+  I2Cx_RX_DMA_DeInit();
+  I2Cx_TX_DMA_DeInit();
   SPIx_DeInit();
+  SPIx_RX_DMA_DeInit();
+  SPIx_TX_DMA_DeInit();
+  Common_ReadyBusyDeInit();
   FDCANx_FORCE_RESET();
   FDCANx_RELEASE_RESET();
   HAL_RCC_DeInit();
   HAL_NVIC_DisableIRQ(USB_FS_IRQn);
-  HAL_NVIC_DisableIRQ(SPIx_IRQn);
+  HAL_NVIC_DisableIRQ(FLASH_IRQn);
+  HAL_NVIC_DisableIRQ(USARTx_IRQn);
+  HAL_NVIC_DisableIRQ(USARTx_RX_DMA_IRQn);
+  HAL_NVIC_DisableIRQ(FDCANx_IT0_IRQn);
 }
 
 /**
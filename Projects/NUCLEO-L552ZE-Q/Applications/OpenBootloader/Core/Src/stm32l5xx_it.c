@@ -21,7 +21,9 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "stm32l5xx_it.h"
-#include "spi_interface.h"
+#include "usart_interface.h"
+#include "fdcan_interface.h"
+#include "flash_interface.h"
 
 /* Private includes ----------------------------------------------------------*/
 /* Private typedef -----------------------------------------------------------*/
@@ -124,11 +126,35 @@ void SysTick_Handler(void)
 /******************************************************************************/
 
 /**
- * @brief This function handles SPIx global interrupt.
+ * @brief This function handles FLASH global interrupt.
  */
-void SPI1_IRQHandler(void)
+void FLASH_IRQHandler(void)
 {
-  OPENBL_SPI_IRQHandler();
+  OPENBL_FLASH_IRQHandler();
+}
+
+/**
+ * @brief This function handles USARTx global interrupt.
+ */
+void USART3_IRQHandler(void)
+{
+  OPENBL_USART_IRQHandler();
+}
+
+/**
+ * @brief This function handles USARTx RX DMA channel interrupt.
+ */
+void DMA1_Channel2_IRQHandler(void)
+{
+  OPENBL_USART_DMA_IRQHandler();
+}
+
+/**
+ * @brief This function handles FDCANx interrupt line 0.
+ */
+void FDCAN1_IT0_IRQHandler(void)
+{
+  OPENBL_FDCAN_IRQHandler();
 }
 
 /**
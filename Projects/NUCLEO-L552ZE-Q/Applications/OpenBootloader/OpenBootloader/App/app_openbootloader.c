@@ -33,6 +33,7 @@
 #include "engibytes_interface.h"
 
 #include "iwdg_interface.h"
+#include "common_interface.h"
 
 #include "openbl_usart_cmd.h"
 #include "openbl_i2c_cmd.h"
@@ -111,12 +112,25 @@ static OPENBL_OpsTypeDef IWDG_Ops =
 /* Exported variables --------------------------------------------------------*/
 uint16_t SpecialCmdList[SPECIAL_CMD_MAX_NUMBER] =
 {
-  SPECIAL_CMD_DEFAULT
+  SPECIAL_CMD_DEFAULT,
+  SPECIAL_CMD_SWAP_BANK,
+  SPECIAL_CMD_CRC32,
+  SPECIAL_CMD_SHA256,
+  SPECIAL_CMD_DECOMPRESS,
+  SPECIAL_CMD_PATCH,
+  SPECIAL_CMD_BAUDRATE,
+  SPECIAL_CMD_FLOW_CONTROL,
+  SPECIAL_CMD_WINDOW_WRITE,
+  SPECIAL_CMD_I2C_SPEED,
+  SPECIAL_CMD_FDCAN_BITRATE,
+  SPECIAL_CMD_FLASH_STATS
 };
 
 uint16_t ExtendedSpecialCmdList[EXTENDED_SPECIAL_CMD_MAX_NUMBER] =
 {
-  SPECIAL_CMD_DEFAULT
+  SPECIAL_CMD_DEFAULT,
+  SPECIAL_CMD_DECOMPRESS,
+  SPECIAL_CMD_PATCH
 };
 
 /* External variables --------------------------------------------------------*/
@@ -130,6 +144,9 @@ uint16_t ExtendedSpecialCmdList[EXTENDED_SPECIAL_CMD_MAX_NUMBER] =
   */
 void OpenBootloader_Init(void)
 {
+  /* Start the timebase of the interfaces and FLASH timeouts */
+  Common_EnableCycleCounter();
+
   /* Register USART interfaces */
   USART_Handle.p_Ops = &USART_Ops;
   USART_Handle.p_Cmd = OPENBL_USART_GetCommandsList();
@@ -176,6 +193,12 @@ void OpenBootloader_Init(void)
   OPENBL_MEM_RegisterMemory(&OB1_Descriptor);
   OPENBL_MEM_RegisterMemory(&OTP_Descriptor);
   OPENBL_MEM_RegisterMemory(&EB_Descriptor);
+
+  /* Initialize the FLASH asynchronous programming */
+  OPENBL_FLASH_Init();
+
+  /* Signal to the SPI and I2C hosts that the device is ready */
+  Common_ReadyBusyConfiguration();
 }
 
 /**
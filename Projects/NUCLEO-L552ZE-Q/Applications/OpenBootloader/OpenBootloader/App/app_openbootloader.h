@@ -30,9 +30,20 @@ extern "C" {
 
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
-#define SPECIAL_CMD_MAX_NUMBER            0x01U  /* Special command max length array */
-#define EXTENDED_SPECIAL_CMD_MAX_NUMBER   0x01U  /* Extended special command max length array */
+#define SPECIAL_CMD_MAX_NUMBER            0x0CU  /* Special command max length array */
+#define EXTENDED_SPECIAL_CMD_MAX_NUMBER   0x03U  /* Extended special command max length array */
 #define SPECIAL_CMD_DEFAULT               0x0102U  /* Default special command */
+#define SPECIAL_CMD_SWAP_BANK             0x0103U  /* Swap the FLASH banks to run the inactive bank image */
+#define SPECIAL_CMD_CRC32                 0x0104U  /* Compute the CRC32 of a memory region */
+#define SPECIAL_CMD_SHA256                0x0105U  /* Compute the SHA-256 digest of a memory region */
+#define SPECIAL_CMD_DECOMPRESS            0x0106U  /* Write a compressed stream decompressed in FLASH */
+#define SPECIAL_CMD_PATCH                 0x0107U  /* Write a new image built from a patch of an image in FLASH */
+#define SPECIAL_CMD_BAUDRATE              0x0108U  /* Switch the USART to a higher baud rate */
+#define SPECIAL_CMD_FLOW_CONTROL          0x0109U  /* Enable or disable the USART RTS/CTS flow control */
+#define SPECIAL_CMD_WINDOW_WRITE          0x010AU  /* Write data with several packets in flight */
+#define SPECIAL_CMD_I2C_SPEED             0x010BU  /* Switch the I2C to another speed mode */
+#define SPECIAL_CMD_FDCAN_BITRATE         0x010CU  /* Switch the FDCAN to another data bit rate */
+#define SPECIAL_CMD_FLASH_STATS           0x010DU  /* Read the FLASH statistics */
 
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
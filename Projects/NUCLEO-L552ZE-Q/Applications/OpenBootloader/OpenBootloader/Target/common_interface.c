@@ -20,6 +20,7 @@
 #include "platform.h"
 #include "flash_interface.h"
 #include "openbootloader_conf.h"
+#include "interfaces_conf.h"
 #include "common_interface.h"
 
 /* Private typedef -----------------------------------------------------------*/
@@ -27,6 +28,7 @@
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static Function_Pointer ResetCallback;
+static FlagStatus ResetOnGoing = RESET;
 
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
@@ -103,3 +105,93 @@ void Common_StartPostProcessing()
     ResetCallback = NULL;
   }
 }
+
+/**
+  * @brief  Reset the device once the deferred FLASH operations are completed.
+  * @note   Used when a transport timeout elapses, so that the data already acknowledged to the host
+  *         is programmed. A timeout elapsing while these operations are completed resets the device
+  *         immediately.
+  * @retval None.
+  */
+void Common_SystemReset(void)
+{
+  if (ResetOnGoing == RESET)
+  {
+    ResetOnGoing = SET;
+
+    (void)OPENBL_FLASH_Flush();
+  }
+
+  NVIC_SystemReset();
+}
+
+/**
+  * @brief  Enable the DWT cycle counter used as the timebase of the timeouts.
+  * @retval None.
+  */
+void Common_EnableCycleCounter(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+  * @brief  Configure the ready/busy line and drive it to the ready level.
+  * @note   The line is only driven when READY_BUSY_LINE is enabled in interfaces_conf.h. It lets
+  *         the SPI and I2C hosts wait for an edge instead of polling the busy byte on the bus.
+  * @retval None.
+  */
+void Common_ReadyBusyConfiguration(void)
+{
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+  if (READY_BUSY_LINE == ENABLE)
+  {
+    READY_BUSY_GPIO_CLK_ENABLE();
+
+    HAL_GPIO_WritePin(READY_BUSY_GPIO_PORT, READY_BUSY_PIN, GPIO_PIN_SET);
+
+    GPIO_InitStruct.Pin   = READY_BUSY_PIN;
+    GPIO_InitStruct.Mode  = GPIO_MODE_OUTPUT_PP;
+    GPIO_InitStruct.Pull  = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init(READY_BUSY_GPIO_PORT, &GPIO_InitStruct);
+  }
+}
+
+/**
+  * @brief  Release the ready/busy line before jumping to the application.
+  * @retval None.
+  */
+void Common_ReadyBusyDeInit(void)
+{
+  if (READY_BUSY_LINE == ENABLE)
+  {
+    HAL_GPIO_DeInit(READY_BUSY_GPIO_PORT, READY_BUSY_PIN);
+  }
+}
+
+/**
+  * @brief  Drive the ready/busy line high, the device is ready for the next command.
+  * @retval None.
+  */
+void Common_SetReady(void)
+{
+  if (READY_BUSY_LINE == ENABLE)
+  {
+    READY_BUSY_GPIO_PORT->BSRR = READY_BUSY_PIN;
+  }
+}
+
+/**
+  * @brief  Drive the ready/busy line low, the device is busy with a FLASH operation.
+  * @retval None.
+  */
+void Common_SetBusy(void)
+{
+  if (READY_BUSY_LINE == ENABLE)
+  {
+    READY_BUSY_GPIO_PORT->BRR = READY_BUSY_PIN;
+  }
+}
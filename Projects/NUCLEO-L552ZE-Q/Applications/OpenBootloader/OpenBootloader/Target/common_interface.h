@@ -32,12 +32,40 @@ typedef void (Send_BusyByte_Func)(void);
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
+
+/**
+  * @brief  Start a timeout measured by the DWT cycle counter.
+  * @note   The function is inlined so that it can be used by the functions executed from SRAM.
+  * @param  Timeout The timeout in us, up to 26 seconds at 80 MHz.
+  * @retval Returns the deadline to be checked with Common_IsTimeoutElapsed.
+  */
+__STATIC_FORCEINLINE uint32_t Common_StartTimeout(uint32_t Timeout)
+{
+  return DWT->CYCCNT + (Timeout * (SystemCoreClock / 1000000U));
+}
+
+/**
+  * @brief  Check whether a timeout started by Common_StartTimeout is elapsed.
+  * @param  Deadline The deadline returned by Common_StartTimeout.
+  * @retval Returns SET if the deadline is reached else returns RESET.
+  */
+__STATIC_FORCEINLINE FlagStatus Common_IsTimeoutElapsed(uint32_t Deadline)
+{
+  return ((int32_t)(DWT->CYCCNT - Deadline) >= 0) ? SET : RESET;
+}
+
 void Common_SetMsp(uint32_t TopOfMainStack);
 void Common_EnableIrq(void);
 void Common_DisableIrq(void);
 FlagStatus Common_GetProtectionStatus(void);
 void Common_SetPostProcessingCallback(Function_Pointer Callback);
 void Common_StartPostProcessing(void);
+void Common_SystemReset(void);
+void Common_EnableCycleCounter(void);
+void Common_ReadyBusyConfiguration(void);
+void Common_ReadyBusyDeInit(void);
+void Common_SetReady(void);
+void Common_SetBusy(void);
 
 #ifdef __cplusplus
 }
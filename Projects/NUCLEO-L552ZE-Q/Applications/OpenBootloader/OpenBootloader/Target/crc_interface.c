@@ -0,0 +1,175 @@
+/**
+  ******************************************************************************
+  * @file    crc_interface.c
+  * @author  MCD Application Team
+  * @brief   Contains CRC computation functions
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "platform.h"
+#include "interfaces_conf.h"
+#include "openbl_mem.h"
+#include "app_openbootloader.h"
+#include "common_interface.h"
+#include "crc_interface.h"
+#include "flash_interface.h"
+#include "iwdg_interface.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define CRC_DMA_MAX_WORDS                 0xFFFFU  /* Maximum number of words of one DMA transfer */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Compute the CRC32 of a memory area with the CRC unit fed by DMA.
+  * @note   The CRC is the standard CRC-32 (polynomial 0x04C11DB7, initial value 0xFFFFFFFF,
+  *         reflected input and output, final XOR 0xFFFFFFFF).
+  *         The DMA only reads aligned words, the bytes before the first word boundary and after
+  *         the last one are written by the CPU.
+  * @param  Address The start address of the area, any alignment.
+  * @param  Length The length of the area in bytes.
+  * @param  pCrc Pointer to the computed CRC32.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: The CRC32 is computed
+  *          - ERROR:   The DMA reported a transfer error while reading the area
+  */
+ErrorStatus OPENBL_CRC_Compute(uint32_t Address, uint32_t Length, uint32_t *pCrc)
+{
+  uint32_t words;
+  uint32_t count;
+  uint32_t index;
+  ErrorStatus status = SUCCESS;
+
+  CRCx_CLK_ENABLE();
+  CRC_DMAMUX_CLK_ENABLE();
+  CRC_DMA_CLK_ENABLE();
+
+  LL_CRC_SetPolynomialCoef(CRC, LL_CRC_DEFAULT_CRC32_POLY);
+  LL_CRC_SetPolynomialSize(CRC, LL_CRC_POLYLENGTH_32B);
+  LL_CRC_SetInitialData(CRC, LL_CRC_DEFAULT_CRC_INITVALUE);
+  LL_CRC_SetOutputDataReverseMode(CRC, LL_CRC_OUTDATA_REVERSE_BIT);
+
+  /* The bytes up to the first word boundary are written one by one, their bits are reversed byte by byte */
+  LL_CRC_SetInputDataReverseMode(CRC, LL_CRC_INDATA_REVERSE_BYTE);
+  LL_CRC_ResetCRCCalculationUnit(CRC);
+
+  while (((Address % 4U) != 0U) && (Length > 0U))
+  {
+    LL_CRC_FeedData8(CRC, *(uint8_t *)Address);
+
+    Address++;
+    Length--;
+  }
+
+  words = Length / 4U;
+
+  /* Reversing the bits of each word processes its bytes in memory order, LSB first */
+  LL_CRC_SetInputDataReverseMode(CRC, LL_CRC_INDATA_REVERSE_WORD);
+
+  /* The DMA reads the words of the area and writes them in the CRC data register */
+  LL_DMA_ConfigTransfer(CRC_DMAx, CRC_DMA_CHANNEL, LL_DMA_DIRECTION_MEMORY_TO_MEMORY | LL_DMA_PRIORITY_HIGH
+                        | LL_DMA_MODE_NORMAL | LL_DMA_PERIPH_INCREMENT | LL_DMA_MEMORY_NOINCREMENT
+                        | LL_DMA_PDATAALIGN_WORD | LL_DMA_MDATAALIGN_WORD);
+  LL_DMA_SetPeriphRequest(CRC_DMAx, CRC_DMA_CHANNEL, LL_DMAMUX_REQ_MEM2MEM);
+
+  while ((words > 0U) && (status == SUCCESS))
+  {
+    count = (words > CRC_DMA_MAX_WORDS) ? CRC_DMA_MAX_WORDS : words;
+
+    LL_DMA_ConfigAddresses(CRC_DMAx, CRC_DMA_CHANNEL, Address, (uint32_t)&(CRC->DR),
+                           LL_DMA_DIRECTION_MEMORY_TO_MEMORY);
+    LL_DMA_SetDataLength(CRC_DMAx, CRC_DMA_CHANNEL, count);
+
+    CRC_DMA_ClearFlag_GI();
+    LL_DMA_EnableChannel(CRC_DMAx, CRC_DMA_CHANNEL);
+
+    /* Wait for the end of the transfer */
+    while ((CRC_DMA_IsActiveFlag_TC() == 0U) && (CRC_DMA_IsActiveFlag_TE() == 0U))
+    {
+      OPENBL_IWDG_Refresh();
+    }
+
+    LL_DMA_DisableChannel(CRC_DMAx, CRC_DMA_CHANNEL);
+
+    /* A bus error aborts the transfer, the CRC of the area is not known */
+    if (CRC_DMA_IsActiveFlag_TE() != 0U)
+    {
+      status = ERROR;
+    }
+
+    Address += count * 4U;
+    words   -= count;
+  }
+
+  CRC_DMA_ClearFlag_GI();
+
+  if (status == SUCCESS)
+  {
+    /* The remaining bytes are written one by one, their bits are reversed byte by byte */
+    LL_CRC_SetInputDataReverseMode(CRC, LL_CRC_INDATA_REVERSE_BYTE);
+
+    for (index = 0U; index < (Length % 4U); index++)
+    {
+      LL_CRC_FeedData8(CRC, *(uint8_t *)(Address + index));
+    }
+
+    *pCrc = LL_CRC_ReadData32(CRC) ^ 0xFFFFFFFFU;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Compute the CRC32 of a memory region requested by the host.
+  * @param  pData The region start address and length (4 bytes each, LSB first).
+  * @param  DataLength The length of the request, must be 8.
+  * @param  pCrc Pointer to the computed CRC32.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: The CRC32 is computed
+  *          - ERROR:   The memory is protected, the region is not valid or cannot be read, or the
+  *                     data written before could not be programmed
+  */
+ErrorStatus OPENBL_CRC_ComputeRegion(uint8_t *pData, uint32_t DataLength, uint32_t *pCrc)
+{
+  uint32_t address;
+  uint32_t length;
+  ErrorStatus status = ERROR;
+
+  if ((DataLength == 8U) && (Common_GetProtectionStatus() == RESET))
+  {
+    address = (uint32_t)pData[0] | ((uint32_t)pData[1] << 8U) | ((uint32_t)pData[2] << 16U)
+              | ((uint32_t)pData[3] << 24U);
+    length  = (uint32_t)pData[4] | ((uint32_t)pData[5] << 8U) | ((uint32_t)pData[6] << 16U)
+              | ((uint32_t)pData[7] << 24U);
+
+    /* The region must be inside one of the registered memories */
+    if ((length != 0U) && ((address + length - 1U) >= address)
+        && (OPENBL_MEM_GetAddressArea(address) != AREA_ERROR)
+        && (OPENBL_MEM_GetAddressArea(address) == OPENBL_MEM_GetAddressArea(address + length - 1U)))
+    {
+      /* Complete the deferred FLASH operations before reading the memory */
+      if (OPENBL_FLASH_Flush() == SUCCESS)
+      {
+        status = OPENBL_CRC_Compute(address, length, pCrc);
+      }
+    }
+  }
+
+  return status;
+}
@@ -0,0 +1,39 @@
+/**
+  ******************************************************************************
+  * @file    crc_interface.h
+  * @author  MCD Application Team
+  * @brief   Header for crc_interface.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CRC_INTERFACE_H
+#define CRC_INTERFACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+ErrorStatus OPENBL_CRC_Compute(uint32_t Address, uint32_t Length, uint32_t *pCrc);
+ErrorStatus OPENBL_CRC_ComputeRegion(uint8_t *pData, uint32_t DataLength, uint32_t *pCrc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC_INTERFACE_H */
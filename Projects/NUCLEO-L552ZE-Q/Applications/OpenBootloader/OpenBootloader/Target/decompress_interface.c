@@ -0,0 +1,259 @@
+/**
+  ******************************************************************************
+  * @file    decompress_interface.c
+  * @author  MCD Application Team
+  * @brief   Contains compressed write functions
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "platform.h"
+#include "openbl_mem.h"
+#include "app_openbootloader.h"
+#include "common_interface.h"
+#include "decompress_interface.h"
+#include "flash_interface.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+  DECOMPRESS_STATE_IDLE = 0U,  /* No compressed write started */
+  DECOMPRESS_STATE_TAG,        /* Reading the tag bit of the next item */
+  DECOMPRESS_STATE_LITERAL,    /* Reading a literal byte */
+  DECOMPRESS_STATE_INDEX,      /* Reading the offset of a back-reference */
+  DECOMPRESS_STATE_COUNT,      /* Reading the length of a back-reference */
+  DECOMPRESS_STATE_ERROR       /* The decompressed data does not fit in the FLASH */
+} DECOMPRESS_StateTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define DECOMPRESS_WINDOW_SIZE            (1UL << DECOMPRESS_WINDOW_BITS)
+#define DECOMPRESS_WINDOW_MASK            (DECOMPRESS_WINDOW_SIZE - 1U)
+#define DECOMPRESS_OUTPUT_SIZE            256U  /* Decompressed bytes written to the FLASH at once */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static DECOMPRESS_StateTypeDef Decompress_State = DECOMPRESS_STATE_IDLE;
+static uint32_t Decompress_Value = 0U;
+static uint32_t Decompress_BitsLeft = 0U;
+static uint32_t Decompress_Offset = 0U;
+static uint32_t Decompress_Head = 0U;
+static uint32_t Decompress_Address = 0U;
+static uint32_t Decompress_Length = 0U;
+static uint32_t Decompress_OutputCount = 0U;
+static uint8_t Decompress_Window[DECOMPRESS_WINDOW_SIZE];
+static uint32_t Decompress_Output[DECOMPRESS_OUTPUT_SIZE / 4U];
+
+/* Private function prototypes -----------------------------------------------*/
+static void OPENBL_DECOMPRESS_PutByte(uint8_t Byte);
+static void OPENBL_DECOMPRESS_WriteOutput(void);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Add one decompressed byte to the window and to the output buffer.
+  * @param  Byte The decompressed byte.
+  * @retval None.
+  */
+static void OPENBL_DECOMPRESS_PutByte(uint8_t Byte)
+{
+  Decompress_Window[Decompress_Head & DECOMPRESS_WINDOW_MASK] = Byte;
+  Decompress_Head++;
+
+  ((uint8_t *)Decompress_Output)[Decompress_OutputCount] = Byte;
+  Decompress_OutputCount++;
+
+  if (Decompress_OutputCount == DECOMPRESS_OUTPUT_SIZE)
+  {
+    OPENBL_DECOMPRESS_WriteOutput();
+  }
+}
+
+/**
+  * @brief  Write the decompressed bytes of the output buffer in FLASH memory.
+  * @note   The decoder stops when the decompressed data exceeds the FLASH memory.
+  * @retval None.
+  */
+static void OPENBL_DECOMPRESS_WriteOutput(void)
+{
+  if (Decompress_OutputCount != 0U)
+  {
+    if (Decompress_OutputCount > (FLASH_END_ADDRESS - Decompress_Address - Decompress_Length))
+    {
+      Decompress_State = DECOMPRESS_STATE_ERROR;
+    }
+    else
+    {
+      OPENBL_FLASH_Write(Decompress_Address + Decompress_Length, (uint8_t *)Decompress_Output,
+                         Decompress_OutputCount);
+
+      Decompress_Length += Decompress_OutputCount;
+    }
+
+    Decompress_OutputCount = 0U;
+  }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Start or end a compressed write requested by the host.
+  * @param  pData The request, DECOMPRESS_CMD_START followed by the FLASH address (4 bytes, LSB first)
+  *         or DECOMPRESS_CMD_END.
+  * @param  DataLength The length of the request, must be 5 for a start and 1 for an end.
+  * @param  pLength Pointer to the number of decompressed bytes written, set when the write is ended.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: The compressed write is started or all its data is written
+  *          - ERROR:   The request is not valid or the decompressed data does not fit in the FLASH or
+  *                     cannot be programmed
+  */
+ErrorStatus OPENBL_DECOMPRESS_Control(uint8_t *pData, uint32_t DataLength, uint32_t *pLength)
+{
+  uint32_t address;
+  ErrorStatus status = ERROR;
+
+  if ((DataLength == 5U) && (pData[0] == DECOMPRESS_CMD_START))
+  {
+    address = (uint32_t)pData[1] | ((uint32_t)pData[2] << 8U) | ((uint32_t)pData[3] << 16U)
+              | ((uint32_t)pData[4] << 24U);
+
+    if ((Common_GetProtectionStatus() == RESET) && (OPENBL_MEM_GetAddressArea(address) == FLASH_AREA))
+    {
+      /* The window is cleared as the back-references may point before the first byte */
+      for (Decompress_Head = 0U; Decompress_Head < DECOMPRESS_WINDOW_SIZE; Decompress_Head++)
+      {
+        Decompress_Window[Decompress_Head] = 0U;
+      }
+
+      Decompress_State       = DECOMPRESS_STATE_TAG;
+      Decompress_Value       = 0U;
+      Decompress_BitsLeft    = 1U;
+      Decompress_Head        = 0U;
+      Decompress_Address     = address;
+      Decompress_Length      = 0U;
+      Decompress_OutputCount = 0U;
+
+      status = SUCCESS;
+    }
+  }
+  else if ((DataLength == 1U) && (pData[0] == DECOMPRESS_CMD_END) && (Decompress_State != DECOMPRESS_STATE_IDLE))
+  {
+    /* The bits of an incomplete item are the padding of the last compressed byte */
+    OPENBL_DECOMPRESS_WriteOutput();
+
+    if (Decompress_State != DECOMPRESS_STATE_ERROR)
+    {
+      status = SUCCESS;
+    }
+
+    /* Program the staged FLASH data so that the image can be checked */
+    if (OPENBL_FLASH_Flush() != SUCCESS)
+    {
+      status = ERROR;
+    }
+
+    *pLength         = Decompress_Length;
+    Decompress_State = DECOMPRESS_STATE_IDLE;
+  }
+  else
+  {
+    /* Nothing to do */
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Decompress a chunk of the compressed stream and write the result in FLASH memory.
+  * @note   The stream has the heatshrink format: each item starts with a tag bit, 1 is followed by
+  *         a literal byte and 0 by a back-reference made of the offset minus one on
+  *         DECOMPRESS_WINDOW_BITS bits and of the length minus one on DECOMPRESS_LOOKAHEAD_BITS bits.
+  *         The bits are read MSB first and an item can be split between two chunks.
+  * @param  pData Pointer to the compressed data.
+  * @param  DataLength The length of the compressed data.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: The chunk is decompressed
+  *          - ERROR:   No compressed write is started or the decompressed data does not fit in the FLASH
+  */
+ErrorStatus OPENBL_DECOMPRESS_Feed(uint8_t *pData, uint32_t DataLength)
+{
+  uint32_t index;
+  uint32_t count;
+  uint32_t mask;
+  ErrorStatus status = SUCCESS;
+
+  for (index = 0U; (index < DataLength) && (Decompress_State != DECOMPRESS_STATE_IDLE)
+       && (Decompress_State != DECOMPRESS_STATE_ERROR); index++)
+  {
+    for (mask = 0x80U; mask != 0U; mask >>= 1U)
+    {
+      Decompress_Value = (Decompress_Value << 1U) | (((pData[index] & mask) != 0U) ? 1U : 0U);
+      Decompress_BitsLeft--;
+
+      if (Decompress_BitsLeft == 0U)
+      {
+        switch (Decompress_State)
+        {
+          case DECOMPRESS_STATE_TAG:
+            if (Decompress_Value != 0U)
+            {
+              Decompress_State    = DECOMPRESS_STATE_LITERAL;
+              Decompress_BitsLeft = 8U;
+            }
+            else
+            {
+              Decompress_State    = DECOMPRESS_STATE_INDEX;
+              Decompress_BitsLeft = DECOMPRESS_WINDOW_BITS;
+            }
+            break;
+
+          case DECOMPRESS_STATE_LITERAL:
+            Decompress_State    = DECOMPRESS_STATE_TAG;
+            Decompress_BitsLeft = 1U;
+
+            OPENBL_DECOMPRESS_PutByte((uint8_t)Decompress_Value);
+            break;
+
+          case DECOMPRESS_STATE_INDEX:
+            Decompress_Offset   = Decompress_Value + 1U;
+            Decompress_State    = DECOMPRESS_STATE_COUNT;
+            Decompress_BitsLeft = DECOMPRESS_LOOKAHEAD_BITS;
+            break;
+
+          case DECOMPRESS_STATE_COUNT:
+            Decompress_State    = DECOMPRESS_STATE_TAG;
+            Decompress_BitsLeft = 1U;
+
+            /* The copy is done byte per byte as the reference can overlap the copied bytes */
+            for (count = Decompress_Value + 1U; count > 0U; count--)
+            {
+              OPENBL_DECOMPRESS_PutByte(Decompress_Window[(Decompress_Head - Decompress_Offset)
+                                                          & DECOMPRESS_WINDOW_MASK]);
+            }
+            break;
+
+          default:
+            break;
+        }
+
+        Decompress_Value = 0U;
+      }
+    }
+  }
+
+  if ((Decompress_State == DECOMPRESS_STATE_IDLE) || (Decompress_State == DECOMPRESS_STATE_ERROR))
+  {
+    status = ERROR;
+  }
+
+  return status;
+}
@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file    decompress_interface.h
+  * @author  MCD Application Team
+  * @brief   Header for decompress_interface.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef DECOMPRESS_INTERFACE_H
+#define DECOMPRESS_INTERFACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+#define DECOMPRESS_CMD_START              0x00U  /* Start a compressed write at the given address */
+#define DECOMPRESS_CMD_END                0x01U  /* End the compressed write and get its decompressed length */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+ErrorStatus OPENBL_DECOMPRESS_Control(uint8_t *pData, uint32_t DataLength, uint32_t *pLength);
+ErrorStatus OPENBL_DECOMPRESS_Feed(uint8_t *pData, uint32_t DataLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DECOMPRESS_INTERFACE_H */
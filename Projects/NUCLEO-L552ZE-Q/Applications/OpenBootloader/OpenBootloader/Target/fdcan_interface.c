@@ -20,19 +20,61 @@
 #include "platform.h"
 #include "openbl_core.h"
 #include "openbl_fdcan_cmd.h"
+#include "app_openbootloader.h"
+#include "common_interface.h"
 #include "fdcan_interface.h"
+#include "flash_interface.h"
+#include "crc_interface.h"
+#include "decompress_interface.h"
+#include "hash_interface.h"
+#include "patch_interface.h"
+#include "window_interface.h"
 #include "iwdg_interface.h"
 #include "interfaces_conf.h"
 
 /* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t Identifier;                        /* Standard identifier of the frame */
+  uint32_t DataLength;                        /* FDCAN data length code of the frame */
+  uint32_t Data[FDCAN_RAM_BUFFER_SIZE / 4U];  /* Frame data, word aligned */
+} FDCAN_RxSlotTypeDef;
+
+typedef struct
+{
+  uint32_t Prescaler;  /* Number of kernel clock cycles per time quantum */
+  uint32_t TimeSeg1;   /* Propagation and phase 1 segments in time quanta */
+  uint32_t TimeSeg2;   /* Phase 2 segment in time quanta, also used as synchronization jump width */
+} FDCAN_BitTimingTypeDef;
+
 /* Private define ------------------------------------------------------------*/
+#define FDCAN_RX_SLOTS                    8U  /* Number of frames of the receive ring buffer */
+#define FDCAN_RX_ELEMENT_SIZE             72U  /* Size in bytes of an RX FIFO element in the message RAM */
+#define FDCAN_WINDOW_MAX_PACKETS          (FDCAN_RX_SLOTS - 1U)  /* Fit in the ring */
+#define FDCAN_TX_ELEMENTS                 3U  /* Number of elements of the TX FIFO and of the TX event FIFO */
+#define FDCAN_DROP_TIME                   10U  /* Time in ms without frame ending the frames dropped on error */
+#define FDCAN_BITRATE_TIMEOUT             1000U  /* Time in ms to get a frame at a new data bit rate */
+#define FDCAN_TDC_BITRATE                 1000000U  /* Data bit rate above which the TX delay is compensated */
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static FDCAN_HandleTypeDef hfdcan;
 static FDCAN_FilterTypeDef sFilterConfig;
 static FDCAN_TxHeaderTypeDef TxHeader;
-static FDCAN_RxHeaderTypeDef RxHeader;
 static uint8_t FdcanDetected = 0U;
+static FDCAN_RxSlotTypeDef FdcanRxSlots[FDCAN_RX_SLOTS];
+static __IO uint32_t FdcanRxHead = 0U;
+static uint32_t FdcanRxTail = 0U;
+static uint32_t FdcanTxPending = 0U;
+static uint32_t FdcanDataBitRate = FDCAN_DATA_BITRATE;
+static uint32_t FdcanOldDataBitRate = FDCAN_DATA_BITRATE;
+static FlagStatus FdcanDataBitRatePending = RESET;
+
+/* Data phase bit rates in bit/s, indexed by FDCAN_DATA_BITRATE_xxx */
+static const uint32_t FdcanDataBitRates[] =
+{
+  1000000U, 2000000U, 4000000U, 5000000U
+};
 
 /* Exported variables --------------------------------------------------------*/
 uint8_t TxData[FDCAN_RAM_BUFFER_SIZE];
@@ -40,6 +82,20 @@ uint8_t RxData[FDCAN_RAM_BUFFER_SIZE];
 
 /* Private function prototypes -----------------------------------------------*/
 static void OPENBL_FDCAN_Init(void);
+static ErrorStatus OPENBL_FDCAN_ComputeBitTiming(uint32_t BitRate, uint32_t MaxPrescaler, uint32_t MaxTimeSeg1,
+                                                 uint32_t MaxTimeSeg2, FDCAN_BitTimingTypeDef *pTiming);
+static void OPENBL_FDCAN_SetDataBitRate(uint32_t DataBitRate);
+static ErrorStatus OPENBL_FDCAN_RequestDataBitRate(uint8_t *pData, uint32_t DataLength);
+static void OPENBL_FDCAN_ApplyDataBitRate(void);
+static void OPENBL_FDCAN_StartReception(void);
+static FDCAN_RxSlotTypeDef *OPENBL_FDCAN_WaitRxFrame(uint32_t Timeout);
+static void OPENBL_FDCAN_ReleaseRxFrame(void);
+static uint32_t OPENBL_FDCAN_GetDataLengthCode(uint32_t Length);
+static uint32_t OPENBL_FDCAN_GetDataLength(uint32_t DataLengthCode);
+static void OPENBL_FDCAN_WaitTxPending(uint32_t MaxPending);
+static void OPENBL_FDCAN_DropRxData(void);
+static void OPENBL_FDCAN_WindowWrite(void);
+static void OPENBL_FDCAN_SendSpecialCmdResponse(uint8_t *pData, uint16_t DataSize, uint8_t Status);
 
 /* Private functions ---------------------------------------------------------*/
 
@@ -49,19 +105,26 @@ static void OPENBL_FDCAN_Init(void);
  */
 static void OPENBL_FDCAN_Init(void)
 {
-  /*                Bit time configuration:
+  /*                Bit time configuration (default, computed at run time):
     Bit time parameter         | Nominal      |  Data
     ---------------------------|--------------|----------------
-    fdcan_ker_ck               | 20 MHz       | 20 MHz
-    Time_quantum (tq)          | 50 ns        | 50 ns
+    fdcan_ker_ck               | 40 MHz       | 40 MHz
+    Time_quantum (tq)          | 25 ns        | 25 ns
     Synchronization_segment    | 1 tq         | 1 tq
-    Propagation_segment        | 23 tq        | 1 tq
-    Phase_segment_1            | 8 tq         | 4 tq
-    Phase_segment_2            | 8 tq         | 4 tq
-    Synchronization_Jump_width | 8 tq         | 4 tq
-    Bit_length                 | 40 tq = 2 us | 10 tq = 0.5 us
+    Time_segment_1             | 63 tq        | 15 tq
+    Time_segment_2             | 16 tq        | 4 tq
+    Synchronization_Jump_width | 16 tq        | 4 tq
+    Bit_length                 | 80 tq = 2 us | 20 tq = 0.5 us
     Bit_rate                   | 0.5 MBit/s   | 2 MBit/s
   */
+  FDCAN_BitTimingTypeDef nominal;
+  FDCAN_BitTimingTypeDef data;
+
+  if ((OPENBL_FDCAN_ComputeBitTiming(FDCAN_NOMINAL_BITRATE, 512U, 256U, 128U, &nominal) != SUCCESS)
+      || (OPENBL_FDCAN_ComputeBitTiming(FdcanDataBitRates[FdcanDataBitRate], 32U, 32U, 16U, &data) != SUCCESS))
+  {
+    while (1);
+  }
 
   hfdcan.Instance                  = FDCANx;
   hfdcan.Init.FrameFormat          = FDCAN_FRAME_FD_BRS;
@@ -69,14 +132,14 @@ static void OPENBL_FDCAN_Init(void)
   hfdcan.Init.AutoRetransmission   = ENABLE;
   hfdcan.Init.TransmitPause        = DISABLE;
   hfdcan.Init.ProtocolException    = ENABLE;
-  hfdcan.Init.NominalPrescaler     = 0x1;
-  hfdcan.Init.NominalSyncJumpWidth = 0x10;
-  hfdcan.Init.NominalTimeSeg1      = 0x3F;
-  hfdcan.Init.NominalTimeSeg2      = 0x10;
-  hfdcan.Init.DataPrescaler        = 0x1;
-  hfdcan.Init.DataSyncJumpWidth    = 0x4;
-  hfdcan.Init.DataTimeSeg1         = 0xF;
-  hfdcan.Init.DataTimeSeg2         = 0x4;
+  hfdcan.Init.NominalPrescaler     = nominal.Prescaler;
+  hfdcan.Init.NominalSyncJumpWidth = nominal.TimeSeg2;
+  hfdcan.Init.NominalTimeSeg1      = nominal.TimeSeg1;
+  hfdcan.Init.NominalTimeSeg2      = nominal.TimeSeg2;
+  hfdcan.Init.DataPrescaler        = data.Prescaler;
+  hfdcan.Init.DataSyncJumpWidth    = data.TimeSeg2;
+  hfdcan.Init.DataTimeSeg1         = data.TimeSeg1;
+  hfdcan.Init.DataTimeSeg2         = data.TimeSeg2;
   hfdcan.Init.StdFiltersNbr        = 1;
   hfdcan.Init.ExtFiltersNbr        = 0;
   hfdcan.Init.TxFifoQueueMode      = FDCAN_TX_FIFO_OPERATION;
@@ -86,6 +149,9 @@ static void OPENBL_FDCAN_Init(void)
     while (1);
   }
 
+  /* Enable the transmitter delay compensation of the fast data phases */
+  OPENBL_FDCAN_SetDataBitRate(FdcanDataBitRate);
+
   /* Configure Rx filter */
   sFilterConfig.IdType       = FDCAN_STANDARD_ID;
   sFilterConfig.FilterIndex  = 0;
@@ -103,13 +169,412 @@ static void OPENBL_FDCAN_Init(void)
   TxHeader.ErrorStateIndicator = FDCAN_ESI_ACTIVE;
   TxHeader.BitRateSwitch       = FDCAN_BRS_ON;
   TxHeader.FDFormat            = FDCAN_FD_CAN;
-  TxHeader.TxEventFifoControl  = FDCAN_NO_TX_EVENTS;
+  TxHeader.TxEventFifoControl  = FDCAN_STORE_TX_EVENTS;
   TxHeader.MessageMarker       = 0;
 
   /* Start the FDCAN module */
   HAL_FDCAN_Start(&hfdcan);
 }
 
+/**
+ * @brief  This function is used to compute the bit timing of a bit rate.
+ * @note   The smallest prescaler giving an integer number of time quanta per bit is used for the
+ *         best resolution, the sample point is set at 80% of the bit.
+ * @param  BitRate The bit rate in bit/s.
+ * @param  MaxPrescaler The maximum prescaler of the phase.
+ * @param  MaxTimeSeg1 The maximum time segment 1 of the phase in time quanta.
+ * @param  MaxTimeSeg2 The maximum time segment 2 of the phase in time quanta.
+ * @param  pTiming Pointer to the computed bit timing.
+ * @retval Returns SUCCESS if the bit rate can be reached exactly with the FDCAN kernel clock else returns ERROR.
+ */
+static ErrorStatus OPENBL_FDCAN_ComputeBitTiming(uint32_t BitRate, uint32_t MaxPrescaler, uint32_t MaxTimeSeg1,
+                                                 uint32_t MaxTimeSeg2, FDCAN_BitTimingTypeDef *pTiming)
+{
+  uint32_t clock = FDCANx_GetClockFreq();
+  uint32_t prescaler;
+  uint32_t quanta;
+  ErrorStatus status = ERROR;
+
+  for (prescaler = 1U; (prescaler <= MaxPrescaler) && (status == ERROR); prescaler++)
+  {
+    if ((clock % (prescaler * BitRate)) == 0U)
+    {
+      quanta = clock / (prescaler * BitRate);
+
+      pTiming->Prescaler = prescaler;
+      pTiming->TimeSeg2  = (quanta + 2U) / 5U;
+      pTiming->TimeSeg1  = quanta - 1U - pTiming->TimeSeg2;
+
+      if ((quanta >= 5U) && (pTiming->TimeSeg1 <= MaxTimeSeg1) && (pTiming->TimeSeg2 <= MaxTimeSeg2))
+      {
+        status = SUCCESS;
+      }
+    }
+  }
+
+  return status;
+}
+
+/**
+ * @brief  This function is used to set the data phase bit timing.
+ * @note   The FDCAN must be in initialization mode. The transmitter delay compensation is enabled
+ *         above FDCAN_TDC_BITRATE, its offset places the secondary sample point at the sample point
+ *         of the data bits. It stays disabled at lower bit rates, the bit timing write clearing it.
+ * @param  DataBitRate The data bit rate, FDCAN_DATA_BITRATE_1M to FDCAN_DATA_BITRATE_5M.
+ * @retval None.
+ */
+static void OPENBL_FDCAN_SetDataBitRate(uint32_t DataBitRate)
+{
+  FDCAN_BitTimingTypeDef data;
+
+  if (OPENBL_FDCAN_ComputeBitTiming(FdcanDataBitRates[DataBitRate], 32U, 32U, 16U, &data) == SUCCESS)
+  {
+    WRITE_REG(hfdcan.Instance->DBTP, ((data.Prescaler - 1U) << FDCAN_DBTP_DBRP_Pos)
+              | ((data.TimeSeg1 - 1U) << FDCAN_DBTP_DTSEG1_Pos)
+              | ((data.TimeSeg2 - 1U) << FDCAN_DBTP_DTSEG2_Pos)
+              | ((data.TimeSeg2 - 1U) << FDCAN_DBTP_DSJW_Pos));
+
+    if (FdcanDataBitRates[DataBitRate] > FDCAN_TDC_BITRATE)
+    {
+      HAL_FDCAN_ConfigTxDelayCompensation(&hfdcan, data.Prescaler * data.TimeSeg1, 0U);
+      HAL_FDCAN_EnableTxDelayCompensation(&hfdcan);
+    }
+  }
+}
+
+/**
+ * @brief  This function is used to check the data bit rate requested by the host.
+ * @note   The data bit rate is applied before receiving the next command, the response of the
+ *         request being sent with the current one.
+ * @param  pData The request, the data bit rate (1 byte).
+ * @param  DataLength The length of the request, must be 1.
+ * @retval Returns SUCCESS if the data bit rate can be reached with the FDCAN kernel clock else returns ERROR.
+ */
+static ErrorStatus OPENBL_FDCAN_RequestDataBitRate(uint8_t *pData, uint32_t DataLength)
+{
+  FDCAN_BitTimingTypeDef data;
+  ErrorStatus status = ERROR;
+
+  if ((DataLength == 1U) && (pData[0] <= FDCAN_DATA_BITRATE_5M)
+      && (OPENBL_FDCAN_ComputeBitTiming(FdcanDataBitRates[pData[0]], 32U, 32U, 16U, &data) == SUCCESS))
+  {
+    FdcanOldDataBitRate     = FdcanDataBitRate;
+    FdcanDataBitRate        = pData[0];
+    FdcanDataBitRatePending = SET;
+    status                  = SUCCESS;
+  }
+
+  return status;
+}
+
+/**
+ * @brief  This function is used to switch the FDCAN to the data bit rate requested by the host.
+ * @note   The previous data bit rate is restored if no frame is received within FDCAN_BITRATE_TIMEOUT,
+ *         so that a host whose transceiver does not support the new bit rate can fall back.
+ * @retval None.
+ */
+static void OPENBL_FDCAN_ApplyDataBitRate(void)
+{
+  uint32_t tick;
+
+  FdcanDataBitRatePending = RESET;
+
+  /* Complete the response sent at the current data bit rate */
+  OPENBL_FDCAN_WaitTxPending(0U);
+
+  HAL_FDCAN_Stop(&hfdcan);
+  OPENBL_FDCAN_SetDataBitRate(FdcanDataBitRate);
+  HAL_FDCAN_Start(&hfdcan);
+
+  /* Wait for the host to send the next command at the new data bit rate */
+  tick = HAL_GetTick();
+
+  while ((FdcanRxHead == FdcanRxTail) && ((HAL_GetTick() - tick) < FDCAN_BITRATE_TIMEOUT))
+  {
+    OPENBL_IWDG_Refresh();
+  }
+
+  if (FdcanRxHead == FdcanRxTail)
+  {
+    FdcanDataBitRate = FdcanOldDataBitRate;
+
+    HAL_FDCAN_Stop(&hfdcan);
+    OPENBL_FDCAN_SetDataBitRate(FdcanDataBitRate);
+    HAL_FDCAN_Start(&hfdcan);
+  }
+}
+
+/**
+ * @brief  This function is used to start the reception of the frames in the receive ring buffer.
+ * @note   The frames are moved from the RX FIFO 0 to the ring buffer by the FDCAN interrupt, so that
+ *         the host can send more frames in a row than the 3 elements of the RX FIFO, typically while
+ *         the FLASH is programmed.
+ * @retval None.
+ */
+static void OPENBL_FDCAN_StartReception(void)
+{
+  FdcanRxHead = 0U;
+  FdcanRxTail = 0U;
+
+  /* The frames already received raise the interrupt as soon as it is enabled */
+  HAL_FDCAN_ActivateNotification(&hfdcan, FDCAN_IT_RX_FIFO0_NEW_MESSAGE, 0U);
+
+  HAL_NVIC_SetPriority(FDCANx_IT0_IRQn, 0U, 0U);
+  HAL_NVIC_EnableIRQ(FDCANx_IT0_IRQn);
+}
+
+/**
+ * @brief  This function is used to wait for a frame in the receive ring buffer.
+ * @note   A system reset occurs if the host does not send any frame before the timeout.
+ * @param  Timeout The time in us waited for a frame, 0 to wait without time limit.
+ * @retval Returns the oldest received frame, it stays in the ring buffer until it is released.
+ */
+static FDCAN_RxSlotTypeDef *OPENBL_FDCAN_WaitRxFrame(uint32_t Timeout)
+{
+  uint32_t deadline = Common_StartTimeout(Timeout);
+
+  while (FdcanRxHead == FdcanRxTail)
+  {
+    OPENBL_IWDG_Refresh();
+
+    if ((Timeout != 0U) && (Common_IsTimeoutElapsed(deadline) == SET))
+    {
+      Common_SystemReset();
+    }
+  }
+
+  return &FdcanRxSlots[FdcanRxTail];
+}
+
+/**
+ * @brief  This function is used to release the oldest frame of the receive ring buffer.
+ * @retval None.
+ */
+static void OPENBL_FDCAN_ReleaseRxFrame(void)
+{
+  FdcanRxTail = (FdcanRxTail + 1U) % FDCAN_RX_SLOTS;
+
+  /* Move the frames left in the RX FIFO 0 while the ring buffer was full */
+  if ((FDCANx->RXF0S & FDCAN_RXF0S_F0FL) != 0U)
+  {
+    NVIC_SetPendingIRQ(FDCANx_IT0_IRQn);
+  }
+}
+
+/**
+ * @brief  This function is used to get the smallest FDCAN data length code fitting a number of bytes.
+ * @param  Length Number of bytes, up to 64.
+ * @retval The FDCAN data length code.
+ */
+static uint32_t OPENBL_FDCAN_GetDataLengthCode(uint32_t Length)
+{
+  uint32_t dlc;
+
+  if (Length <= 8U)
+  {
+    dlc = Length;
+  }
+  else if (Length <= 24U)
+  {
+    /* 12, 16, 20 and 24 bytes frames */
+    dlc = 9U + ((Length - 9U) / 4U);
+  }
+  else if (Length <= 32U)
+  {
+    dlc = 13U;
+  }
+  else if (Length <= 48U)
+  {
+    dlc = 14U;
+  }
+  else
+  {
+    dlc = 15U;
+  }
+
+  /* The HAL data length codes are the DLC field values */
+  return (FDCAN_DLC_BYTES_1 * dlc);
+}
+
+/**
+ * @brief  This function is used to get the number of bytes of a FDCAN data length code.
+ * @param  DataLengthCode The FDCAN data length code.
+ * @retval The number of bytes, up to 64.
+ */
+static uint32_t OPENBL_FDCAN_GetDataLength(uint32_t DataLengthCode)
+{
+  uint32_t dlc = DataLengthCode / FDCAN_DLC_BYTES_1;
+  uint32_t length;
+
+  if (dlc <= 8U)
+  {
+    length = dlc;
+  }
+  else if (dlc <= 12U)
+  {
+    /* 12, 16, 20 and 24 bytes frames */
+    length = (dlc - 6U) * 4U;
+  }
+  else if (dlc == 13U)
+  {
+    length = 32U;
+  }
+  else if (dlc == 14U)
+  {
+    length = 48U;
+  }
+  else
+  {
+    length = 64U;
+  }
+
+  return length;
+}
+
+/**
+ * @brief  This function is used to wait until at most a given number of sent frames are pending.
+ * @note   A frame is pending from its queuing in the TX FIFO until its TX event is read. Limiting
+ *         the pending frames to FDCAN_TX_ELEMENTS keeps a free TX FIFO element for each new frame
+ *         and ensures that no TX event is lost. A system reset occurs if the frames are not sent
+ *         before the timeout.
+ * @param  MaxPending The maximum number of pending frames, 0 to wait for the end of the transmission.
+ * @retval None.
+ */
+static void OPENBL_FDCAN_WaitTxPending(uint32_t MaxPending)
+{
+  FDCAN_TxEventFifoTypeDef tx_event;
+  uint32_t deadline = Common_StartTimeout(OPENBL_FDCAN_TIMEOUT);
+
+  while (FdcanTxPending > MaxPending)
+  {
+    if (HAL_FDCAN_GetTxEvent(&hfdcan, &tx_event) == HAL_OK)
+    {
+      FdcanTxPending--;
+    }
+    else if (Common_IsTimeoutElapsed(deadline) == SET)
+    {
+      Common_SystemReset();
+    }
+    else
+    {
+      /* The frames are still being sent */
+    }
+  }
+}
+
+/**
+ * @brief  This function is used to drop the received frames until the host stops sending.
+ * @retval None.
+ */
+static void OPENBL_FDCAN_DropRxData(void)
+{
+  uint32_t tick = HAL_GetTick();
+
+  while ((HAL_GetTick() - tick) < FDCAN_DROP_TIME)
+  {
+    if (FdcanRxHead != FdcanRxTail)
+    {
+      OPENBL_FDCAN_ReleaseRxFrame();
+
+      tick = HAL_GetTick();
+    }
+
+    OPENBL_IWDG_Refresh();
+  }
+}
+
+/**
+ * @brief  This function is used to receive the frames of a windowed write.
+ * @note   A frame is the packet sequence number, the packet data length and the packet data, the
+ *         bytes after the data pad the frame to a valid FD data length and are not written. A frame
+ *         with a data length of 0 ends the write. The frames are acknowledged with ACK followed by
+ *         the next expected sequence number, twice per window and after the end frame. On error,
+ *         NACK is sent followed by the first failed sequence number and the frames in flight are dropped.
+ *         The packet data is written from the receive ring buffer without intermediate copy.
+ * @retval None.
+ */
+static void OPENBL_FDCAN_WindowWrite(void)
+{
+  FDCAN_RxSlotTypeDef *frame;
+  uint8_t *data;
+  uint32_t length;
+  ErrorStatus status = SUCCESS;
+  FlagStatus end     = RESET;
+
+  while ((status == SUCCESS) && (end == RESET))
+  {
+    frame  = OPENBL_FDCAN_WaitRxFrame(OPENBL_FDCAN_TIMEOUT);
+    data   = (uint8_t *)frame->Data;
+    length = OPENBL_FDCAN_GetDataLength(frame->DataLength);
+
+    /* The data length given by the host must fit in the frame, the padding bytes are ignored */
+    if ((length < 2U) || (data[1] > (length - 2U)))
+    {
+      status = ERROR;
+    }
+    else if (data[1] == 0U)
+    {
+      status = OPENBL_WINDOW_End(data[0]);
+      end    = SET;
+    }
+    else
+    {
+      status = OPENBL_WINDOW_Write(data[0], &data[2], data[1]);
+    }
+
+    OPENBL_FDCAN_ReleaseRxFrame();
+
+    if (status == ERROR)
+    {
+      TxData[0] = NACK_BYTE;
+      TxData[1] = OPENBL_WINDOW_GetSequence();
+
+      OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_2);
+      OPENBL_FDCAN_DropRxData();
+    }
+    else if ((end == SET) || (OPENBL_WINDOW_IsAckRequired() == SET))
+    {
+      TxData[0] = ACK_BYTE;
+      TxData[1] = OPENBL_WINDOW_GetSequence();
+
+      OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_2);
+    }
+    else
+    {
+      /* Keep receiving the frames in flight */
+    }
+  }
+}
+
+/**
+ * @brief  This function is used to send the response of a special command in one frame.
+ * @param  pData Pointer to the data to be sent, can be NULL if DataSize is 0.
+ * @param  DataSize Number of data bytes, up to 59.
+ * @param  Status Status byte sent after the data.
+ * @retval None.
+ */
+static void OPENBL_FDCAN_SendSpecialCmdResponse(uint8_t *pData, uint16_t DataSize, uint8_t Status)
+{
+  uint16_t index;
+
+  /* Data size */
+  TxData[0] = (uint8_t)(DataSize >> 8U);
+  TxData[1] = (uint8_t)(DataSize & 0xFFU);
+
+  /* Data */
+  for (index = 0U; index < DataSize; index++)
+  {
+    TxData[2U + index] = pData[index];
+  }
+
+  /* Status size and status */
+  TxData[2U + DataSize] = 0x00U;
+  TxData[3U + DataSize] = 0x01U;
+  TxData[4U + DataSize] = Status;
+
+  OPENBL_FDCAN_SendBytes(TxData, OPENBL_FDCAN_GetDataLengthCode(5U + (uint32_t)DataSize));
+}
+
 /* Exported functions --------------------------------------------------------*/
 
 /**
@@ -127,6 +592,9 @@ void OPENBL_FDCAN_Configuration(void)
  */
 void OPENBL_FDCAN_DeInit(void)
 {
+  /* Complete the transmission of the queued frames, typically the acknowledge of a Go command */
+  OPENBL_FDCAN_WaitTxPending(0U);
+
   /* Only de-initialize the FDCAN if it is not the current detected interface */
   if (FdcanDetected == 0U)
   {
@@ -149,6 +617,8 @@ uint8_t OPENBL_FDCAN_ProtocolDetection(void)
   if (HAL_FDCAN_GetRxFifoFillLevel(&hfdcan, FDCAN_RX_FIFO0) > 0)
   {
     FdcanDetected = 1;
+
+    OPENBL_FDCAN_StartReception();
   }
   else
   {
@@ -164,27 +634,24 @@ uint8_t OPENBL_FDCAN_ProtocolDetection(void)
  */
 uint8_t OPENBL_FDCAN_GetCommandOpcode(void)
 {
-  uint8_t command_opc      = 0x0;
-  HAL_StatusTypeDef status = HAL_OK;
-
-  /* check if FIFO 0 receive at least one message */
-  while (HAL_FDCAN_GetRxFifoFillLevel(&hfdcan, FDCAN_RX_FIFO0) < 1)
-  {}
+  FDCAN_RxSlotTypeDef *frame;
+  uint8_t command_opc;
 
-  /* Retrieve Rx messages from RX FIFO0 */
-  status = HAL_FDCAN_GetRxMessage(&hfdcan, FDCAN_RX_FIFO0, &RxHeader, RxData);
-
-  /* Check for errors */
-  if (status == HAL_ERROR)
+  /* Switch to the data bit rate requested by the previous command */
+  if (FdcanDataBitRatePending == SET)
   {
-    command_opc = ERROR_COMMAND;
-  }
-  else
-  {
-    command_opc         = RxHeader.Identifier;
-    TxHeader.Identifier = RxHeader.Identifier;
+    OPENBL_FDCAN_ApplyDataBitRate();
   }
 
+  /* Wait for the next command without time limit */
+  frame = OPENBL_FDCAN_WaitRxFrame(0U);
+
+  command_opc         = (uint8_t)frame->Identifier;
+  TxHeader.Identifier = frame->Identifier;
+
+  /* Retrieve the command data */
+  OPENBL_FDCAN_ReadBytes(RxData, FDCAN_RAM_BUFFER_SIZE);
+
   return command_opc;
 }
 
@@ -194,38 +661,47 @@ uint8_t OPENBL_FDCAN_GetCommandOpcode(void)
   */
 uint8_t OPENBL_FDCAN_ReadByte(void)
 {
-  uint8_t byte = 0x0;
+  FDCAN_RxSlotTypeDef *frame;
+  uint8_t byte;
 
-  /* check if FIFO 0 receive at least one message */
-  while (HAL_FDCAN_GetRxFifoFillLevel(&hfdcan, FDCAN_RX_FIFO0) < 1)
-  {
-    OPENBL_IWDG_Refresh();
-  }
+  /* The byte is the first one of the next frame */
+  frame = OPENBL_FDCAN_WaitRxFrame(OPENBL_FDCAN_TIMEOUT);
+  byte  = ((uint8_t *)frame->Data)[0];
 
-  /* Retrieve Rx messages from RX FIFO0 */
-  HAL_FDCAN_GetRxMessage(&hfdcan, FDCAN_RX_FIFO0, &RxHeader, &byte);
+  OPENBL_FDCAN_ReleaseRxFrame();
 
   return byte;
 }
 
 /**
   * @brief  This function is used to read bytes from FDCAN pipe.
+  * @note   The data of the next frame is copied from the receive ring buffer.
+  * @param  Buffer Pointer to the buffer receiving the frame data, of FDCAN_RAM_BUFFER_SIZE bytes.
+  * @param  BufferSize Not used, the whole frame data is copied.
   * @retval None.
   */
 void OPENBL_FDCAN_ReadBytes(uint8_t *Buffer, uint32_t BufferSize)
 {
-  /* check if FIFO 0 receive at least one message */
-  while (HAL_FDCAN_GetRxFifoFillLevel(&hfdcan, FDCAN_RX_FIFO0) < 1)
+  FDCAN_RxSlotTypeDef *frame;
+  uint32_t length;
+  uint32_t index;
+
+  frame  = OPENBL_FDCAN_WaitRxFrame(OPENBL_FDCAN_TIMEOUT);
+  length = OPENBL_FDCAN_GetDataLength(frame->DataLength);
+
+  for (index = 0U; index < length; index++)
   {
-    OPENBL_IWDG_Refresh();
+    Buffer[index] = ((uint8_t *)frame->Data)[index];
   }
 
-  /* Retrieve Rx messages from RX FIFO0 */
-  HAL_FDCAN_GetRxMessage(&hfdcan, FDCAN_RX_FIFO0, &RxHeader, Buffer);
+  OPENBL_FDCAN_ReleaseRxFrame();
 }
 
 /**
   * @brief  This function is used to send one byte through FDCAN pipe.
+  * @note   The single bytes are the acknowledges of the commands, the function returns once the
+  *         byte and the frames queued before it are sent, so that a reset or a jump following the
+  *         acknowledge does not drop it.
   * @param  Byte The byte to be sent.
   * @retval None.
   */
@@ -233,21 +709,18 @@ void OPENBL_FDCAN_SendByte(uint8_t Byte)
 {
   TxHeader.DataLength = FDCAN_DLC_BYTES_1;
 
-  while (HAL_FDCAN_GetTxFifoFreeLevel(&hfdcan) == 0)
-  {}
+  OPENBL_FDCAN_WaitTxPending(FDCAN_TX_ELEMENTS - 1U);
 
   HAL_FDCAN_AddMessageToTxFifoQ(&hfdcan, &TxHeader, &Byte);
+  FdcanTxPending++;
 
-  /* Wait that the data is completely sent (sent FIFO empty) */
-  while (((&hfdcan)->Instance->IR & FDCAN_IR_TFE) != FDCAN_IR_TFE)
-  {}
-
-  /* Clear the complete flag */
-  (&hfdcan)->Instance->IR &= FDCAN_IR_TFE;
+  OPENBL_FDCAN_WaitTxPending(0U);
 }
 
 /**
   * @brief  This function is used to send a buffer using FDCAN.
+  * @note   The frame is copied in the TX FIFO and the function returns without waiting for its
+  *         transmission, so that the frames of a multi-frame response are sent back-to-back.
   * @param  Buffer The data buffer to be sent.
   * @param  BufferSize The size of the data buffer to be sent.
   * @retval None.
@@ -256,17 +729,10 @@ void OPENBL_FDCAN_SendBytes(uint8_t *Buffer, uint32_t BufferSize)
 {
   TxHeader.DataLength = BufferSize;
 
-  while (HAL_FDCAN_GetTxFifoFreeLevel(&hfdcan) == 0)
-  {}
+  OPENBL_FDCAN_WaitTxPending(FDCAN_TX_ELEMENTS - 1U);
 
   HAL_FDCAN_AddMessageToTxFifoQ(&hfdcan, &TxHeader, Buffer);
-
-  /* Wait that the data is completely sent (sent FIFO empty) */
-  while (((&hfdcan)->Instance->IR & FDCAN_IR_TFE) != FDCAN_IR_TFE)
-  {}
-
-  /* Clear the complete flag */
-  (&hfdcan)->Instance->IR &= FDCAN_IR_TFE;
+  FdcanTxPending++;
 }
 
 /**
@@ -276,8 +742,221 @@ void OPENBL_FDCAN_SendBytes(uint8_t *Buffer, uint32_t BufferSize)
  */
 void OPENBL_FDCAN_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *Frame)
 {
+  ErrorStatus status;
+  uint32_t crc = 0U;
+  uint32_t length = 0U;
+  uint8_t data[HASH_SHA256_DIGEST_SIZE];
+
   switch (Frame->OpCode)
   {
+    /* Swap the FLASH banks */
+    case SPECIAL_CMD_SWAP_BANK:
+      if (Frame->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_FLASH_SwapBank(Frame->Buffer1, Frame->SizeBuffer1);
+
+        OPENBL_FDCAN_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+      }
+      else
+      {
+        /* Send NULL status size */
+        TxData[0] = 0x0;
+        TxData[1] = 0x0;
+
+        OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_2);
+      }
+      break;
+
+    /* Compute the CRC32 of a memory region */
+    case SPECIAL_CMD_CRC32:
+      if (Frame->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_CRC_ComputeRegion(Frame->Buffer1, Frame->SizeBuffer1, &crc);
+
+        data[0] = (uint8_t)(crc & 0xFFU);
+        data[1] = (uint8_t)((crc >> 8U) & 0xFFU);
+        data[2] = (uint8_t)((crc >> 16U) & 0xFFU);
+        data[3] = (uint8_t)((crc >> 24U) & 0xFFU);
+
+        if (status == SUCCESS)
+        {
+          OPENBL_FDCAN_SendSpecialCmdResponse(data, 4U, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_FDCAN_SendSpecialCmdResponse(NULL, 0U, NACK_BYTE);
+        }
+      }
+      else
+      {
+        /* Send NULL status size */
+        TxData[0] = 0x0;
+        TxData[1] = 0x0;
+
+        OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_2);
+      }
+      break;
+
+    /* Compute the SHA-256 digest of a memory region */
+    case SPECIAL_CMD_SHA256:
+      if (Frame->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_HASH_ComputeRegion(Frame->Buffer1, Frame->SizeBuffer1, data);
+
+        if (status == SUCCESS)
+        {
+          OPENBL_FDCAN_SendSpecialCmdResponse(data, HASH_SHA256_DIGEST_SIZE, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_FDCAN_SendSpecialCmdResponse(NULL, 0U, NACK_BYTE);
+        }
+      }
+      else
+      {
+        /* Send NULL status size */
+        TxData[0] = 0x0;
+        TxData[1] = 0x0;
+
+        OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_2);
+      }
+      break;
+
+    /* Write a compressed stream decompressed in FLASH */
+    case SPECIAL_CMD_DECOMPRESS:
+      if (Frame->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_DECOMPRESS_Control(Frame->Buffer1, Frame->SizeBuffer1, &length);
+
+        if ((status == SUCCESS) && (Frame->Buffer1[0] == DECOMPRESS_CMD_END))
+        {
+          /* Send the number of decompressed bytes */
+          data[0] = (uint8_t)(length & 0xFFU);
+          data[1] = (uint8_t)((length >> 8U) & 0xFFU);
+          data[2] = (uint8_t)((length >> 16U) & 0xFFU);
+          data[3] = (uint8_t)((length >> 24U) & 0xFFU);
+
+          OPENBL_FDCAN_SendSpecialCmdResponse(data, 4U, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_FDCAN_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+        }
+      }
+      else
+      {
+        status = OPENBL_DECOMPRESS_Feed(Frame->Buffer2, Frame->SizeBuffer2);
+
+        /* Send status */
+        TxData[0] = 0x0;
+        TxData[1] = 0x1;
+        TxData[2] = (status == SUCCESS) ? ACK_BYTE : NACK_BYTE;
+
+        OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_3);
+      }
+      break;
+
+    /* Write a new image built from a patch of an image in FLASH */
+    case SPECIAL_CMD_PATCH:
+      if (Frame->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_PATCH_Control(Frame->Buffer1, Frame->SizeBuffer1, &length);
+
+        if ((status == SUCCESS) && (Frame->Buffer1[0] == PATCH_CMD_END))
+        {
+          /* Send the length of the new image */
+          data[0] = (uint8_t)(length & 0xFFU);
+          data[1] = (uint8_t)((length >> 8U) & 0xFFU);
+          data[2] = (uint8_t)((length >> 16U) & 0xFFU);
+          data[3] = (uint8_t)((length >> 24U) & 0xFFU);
+
+          OPENBL_FDCAN_SendSpecialCmdResponse(data, 4U, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_FDCAN_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+        }
+      }
+      else
+      {
+        status = OPENBL_PATCH_Feed(Frame->Buffer2, Frame->SizeBuffer2);
+
+        /* Send status */
+        TxData[0] = 0x0;
+        TxData[1] = 0x1;
+        TxData[2] = (status == SUCCESS) ? ACK_BYTE : NACK_BYTE;
+
+        OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_3);
+      }
+      break;
+
+    /* Write data with several frames in flight */
+    case SPECIAL_CMD_WINDOW_WRITE:
+      if (Frame->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_WINDOW_Start(Frame->Buffer1, Frame->SizeBuffer1, FDCAN_WINDOW_MAX_PACKETS);
+
+        OPENBL_FDCAN_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+
+        if (status == SUCCESS)
+        {
+          OPENBL_FDCAN_WindowWrite();
+        }
+      }
+      else
+      {
+        /* Send NULL status size */
+        TxData[0] = 0x0;
+        TxData[1] = 0x0;
+
+        OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_2);
+      }
+      break;
+
+    /* Switch the FDCAN to another data bit rate */
+    case SPECIAL_CMD_FDCAN_BITRATE:
+      if (Frame->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_FDCAN_RequestDataBitRate(Frame->Buffer1, Frame->SizeBuffer1);
+
+        /* The response is sent at the current data bit rate */
+        OPENBL_FDCAN_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+      }
+      else
+      {
+        /* Send NULL status size */
+        TxData[0] = 0x0;
+        TxData[1] = 0x0;
+
+        OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_2);
+      }
+      break;
+
+    /* Read the FLASH statistics */
+    case SPECIAL_CMD_FLASH_STATS:
+      if (Frame->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_FLASH_GetStatistics(Frame->Buffer1, Frame->SizeBuffer1, data);
+
+        if (status == SUCCESS)
+        {
+          OPENBL_FDCAN_SendSpecialCmdResponse(data, FLASH_STATS_SIZE, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_FDCAN_SendSpecialCmdResponse(NULL, 0U, NACK_BYTE);
+        }
+      }
+      else
+      {
+        /* Send NULL status size */
+        TxData[0] = 0x0;
+        TxData[1] = 0x0;
+
+        OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_2);
+      }
+      break;
+
     /* Unknown command opcode */
     default:
       if (Frame->CmdType == OPENBL_SPECIAL_CMD)
@@ -303,3 +982,51 @@ void OPENBL_FDCAN_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *Frame)
       break;
   }
 }
+
+/**
+  * @brief  Handle FDCAN interrupt request.
+  * @note   The frames of the RX FIFO 0 are read directly in the message RAM, so that the interrupt
+  *         is served from SRAM during the FLASH operations.
+  * @retval None.
+  */
+#if defined (__ICCARM__)
+__ramfunc void OPENBL_FDCAN_IRQHandler(void)
+#else
+__attribute__((section(".ramfunc"))) void OPENBL_FDCAN_IRQHandler(void)
+#endif /* (__ICCARM__) */
+{
+  FDCAN_RxSlotTypeDef *frame;
+  uint32_t *element;
+  uint32_t index;
+  uint32_t word;
+  uint32_t next;
+
+  /* Clear the flag first, so that a frame received while the FIFO is read raises a new interrupt */
+  FDCANx->IR = FDCAN_IR_RF0N;
+
+  next = (FdcanRxHead + 1U) % FDCAN_RX_SLOTS;
+
+  /* The frames stay in the RX FIFO 0 while the ring buffer is full, the reader moves them later */
+  while (((FDCANx->RXF0S & FDCAN_RXF0S_F0FL) != 0U) && (next != FdcanRxTail))
+  {
+    index   = (FDCANx->RXF0S & FDCAN_RXF0S_F0GI) >> FDCAN_RXF0S_F0GI_Pos;
+    element = (uint32_t *)(hfdcan.msgRam.RxFIFO0SA + (index * FDCAN_RX_ELEMENT_SIZE));
+    frame   = &FdcanRxSlots[FdcanRxHead];
+
+    /* Element header: standard identifier in bits 28:18 of R0, data length code in bits 19:16 of R1 */
+    frame->Identifier = (element[0] >> 18U) & 0x7FFU;
+    frame->DataLength = ((element[1] >> 16U) & 0xFU) * FDCAN_DLC_BYTES_1;
+
+    /* The message RAM is read by words, the whole data field is copied */
+    for (word = 0U; word < (FDCAN_RAM_BUFFER_SIZE / 4U); word++)
+    {
+      frame->Data[word] = element[2U + word];
+    }
+
+    /* Release the RX FIFO 0 element */
+    FDCANx->RXF0A = index;
+
+    FdcanRxHead = next;
+    next        = (next + 1U) % FDCAN_RX_SLOTS;
+  }
+}
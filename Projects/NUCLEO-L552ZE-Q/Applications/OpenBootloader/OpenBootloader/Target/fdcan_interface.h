@@ -30,6 +30,11 @@ extern "C" {
 
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
+#define FDCAN_DATA_BITRATE_1M             0x00U  /* 1 Mbit/s data phase */
+#define FDCAN_DATA_BITRATE_2M             0x01U  /* 2 Mbit/s data phase */
+#define FDCAN_DATA_BITRATE_4M             0x02U  /* 4 Mbit/s data phase */
+#define FDCAN_DATA_BITRATE_5M             0x03U  /* 5 Mbit/s data phase */
+
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 void OPENBL_FDCAN_Configuration(void);
@@ -42,6 +47,7 @@ void OPENBL_FDCAN_ReadBytes(uint8_t *Buffer, uint32_t BufferSize);
 void OPENBL_FDCAN_SendByte(uint8_t Byte);
 void OPENBL_FDCAN_SendBytes(uint8_t *Buffer, uint32_t BufferSize);
 void OPENBL_FDCAN_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *Frame);
+void OPENBL_FDCAN_IRQHandler(void);
 
 #ifdef __cplusplus
 }
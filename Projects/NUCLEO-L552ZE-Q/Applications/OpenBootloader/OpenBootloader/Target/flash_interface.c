@@ -21,19 +21,62 @@
 #include "openbl_mem.h"
 #include "app_openbootloader.h"
 #include "common_interface.h"
+#include "crc_interface.h"
 #include "flash_interface.h"
+#include "hash_interface.h"
 #include "i2c_interface.h"
+#include "iwdg_interface.h"
 #include "optionbytes_interface.h"
 
 /* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t Address;                        /* FLASH address of the job */
+  uint32_t Length;                         /* Number of bytes to program, multiple of a double-word */
+  uint32_t Index;                          /* Offset of the double-word being programmed */
+  uint32_t Data[64U];                      /* Data to program, one row of 256 bytes */
+} OPENBL_FLASH_JobTypeDef;
+
 /* Private define ------------------------------------------------------------*/
 #define FLASH_PAGE_MAX_NUMBER             ((uint8_t)0x7FU)
 #define FLASH_PROG_STEP_SIZE              ((uint8_t)0x8U)
+#define FLASH_ROW_SIZE                    ((uint16_t)0x100U)
 #define FLASH_PAGE_NUMBER                 ((uint16_t)256U)
+#define FLASH_BANK_PAGE_NUMBER            (FLASH_PAGE_NUMBER / 2U)
+#define FLASH_PAGE_DWORDS                 (FLASH_PAGE_SIZE / FLASH_PROG_STEP_SIZE)
+#define FLASH_DELTA_NO_PAGE               ((uint32_t)0xFFFFFFFFU)
+#define FLASH_ASYNC_JOBS                  2U
+#define FLASH_NO_STAGING                  ((uint32_t)0xFFFFFFFFU)
+#define FLASH_INACTIVE_BANK_ADDRESS       (FLASH_START_ADDRESS + FLASH_BANK_SIZE)  /* Whatever the swap state */
+#define FLASH_ERROR_TIMEOUT               ((uint32_t)0x80000000U)  /* FLASH operation not completed in time */
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static uint32_t Flash_BusyState = FLASH_BUSY_STATE_DISABLED;
+static uint32_t Flash_SkippedErases = 0U;
+#if (FLASH_DELTA_MODE == 1U)
+static uint32_t Flash_DeltaPage = FLASH_DELTA_NO_PAGE;
+static uint32_t Flash_PendingPages = 0U;
+static uint32_t Flash_PendingErase[FLASH_PAGE_NUMBER / 32U];
+static uint32_t Flash_DeltaWritten[FLASH_PAGE_DWORDS / 32U];
+static uint32_t Flash_PageBuffer[FLASH_PAGE_SIZE / 4U];
+#endif /* (FLASH_DELTA_MODE == 1U) */
+static const FunctionalState Flash_AsyncMode = FLASH_ASYNC_MODE;
+static OPENBL_FLASH_JobTypeDef Flash_Jobs[FLASH_ASYNC_JOBS];
+static __IO uint32_t Flash_JobsHead = 0U;
+static __IO uint32_t Flash_JobsCount = 0U;
+static uint32_t Flash_JobsTail = 0U;
+static __IO uint32_t Flash_JobStartCycle = 0U;
+static __IO uint32_t Flash_BusyCycles = 0U;
+static uint32_t Flash_StallCycles = 0U;
+static __IO uint32_t Flash_ProgramError = 0U;
+static uint32_t Flash_ErrorFlags = 0U;
+static uint32_t Flash_SyncCycles = 0U;
+static uint32_t Flash_SyncBytes = 0U;
+static uint32_t Flash_AsyncBytes = 0U;
+static uint32_t Flash_StagingAddress = FLASH_NO_STAGING;
+static uint32_t Flash_StagingNext = 0U;
+static uint32_t Flash_StagingData[FLASH_PROG_STEP_SIZE / 4U];
 static FLASH_ProcessTypeDef FlashProcess = {.Lock = HAL_UNLOCKED, \
                                             .ErrorCode = HAL_FLASH_ERROR_NONE, \
                                             .ProcedureOnGoing = 0U, \
@@ -44,9 +87,39 @@ static FLASH_ProcessTypeDef FlashProcess = {.Lock = HAL_UNLOCKED, \
                                            };
 
 /* Private function prototypes -----------------------------------------------*/
-static void OPENBL_FLASH_Program(uint32_t Address, uint64_t Data);
+static HAL_StatusTypeDef OPENBL_FLASH_Program(uint32_t Address, uint64_t Data);
 static ErrorStatus OPENBL_FLASH_EnableWriteProtection(uint8_t *ListOfPages, uint32_t Length);
 static ErrorStatus OPENBL_FLASH_DisableWriteProtection(void);
+static FlagStatus OPENBL_FLASH_IsPageBlank(uint32_t Address);
+static uint32_t OPENBL_FLASH_EraseBankPages(uint32_t *pPagesList, uint32_t Bank);
+static FlagStatus OPENBL_FLASH_IsBankWriteProtected(uint32_t Bank);
+static void OPENBL_FLASH_ProgramData(uint32_t Address, uint8_t *pData, uint32_t DataLength);
+static void OPENBL_FLASH_WriteData(uint32_t Address, uint8_t *pData, uint32_t DataLength);
+static void OPENBL_FLASH_StagingOpen(uint32_t Address);
+static void OPENBL_FLASH_StagingFlush(void);
+static void OPENBL_FLASH_Complete(void);
+static void OPENBL_FLASH_SaveProgramError(uint32_t ErrorCode);
+static uint32_t OPENBL_FLASH_GetPage(uint32_t Address);
+static uint32_t OPENBL_FLASH_GetPageAddress(uint32_t Page);
+#if (FLASH_DELTA_MODE == 1U)
+static HAL_StatusTypeDef OPENBL_FLASH_ErasePage(uint32_t Page);
+static void OPENBL_FLASH_DeltaWrite(uint32_t Address, uint8_t *pData, uint32_t DataLength);
+static FlagStatus OPENBL_FLASH_DeltaCompare(uint32_t Address, uint8_t *pData, uint32_t DataLength);
+static void OPENBL_FLASH_DeltaRewritePage(uint32_t Address, uint8_t *pData, uint32_t DataLength);
+static void OPENBL_FLASH_DeltaClosePage(void);
+static void OPENBL_FLASH_DeltaDiscard(uint32_t FirstPage, uint32_t LastPage);
+#endif /* (FLASH_DELTA_MODE == 1U) */
+static void OPENBL_FLASH_AsyncWrite(uint32_t Address, uint8_t *pData, uint32_t DataLength);
+static void OPENBL_FLASH_AsyncWait(uint32_t MaxJobs);
+static ErrorStatus OPENBL_FLASH_CheckInactiveBank(uint8_t *pData, uint32_t DataLength);
+#if defined (__ICCARM__)
+__ramfunc HAL_StatusTypeDef OPENBL_FLASH_ProgramRow(uint32_t Address, uint8_t *pData, uint32_t Length);
+__ramfunc void OPENBL_FLASH_AsyncStartJob(OPENBL_FLASH_JobTypeDef *pJob);
+#else
+__attribute__((section(".ramfunc"))) HAL_StatusTypeDef OPENBL_FLASH_ProgramRow(uint32_t Address, uint8_t *pData,
+                                                                            uint32_t Length);
+__attribute__((section(".ramfunc"))) void OPENBL_FLASH_AsyncStartJob(OPENBL_FLASH_JobTypeDef *pJob);
+#endif /* (__ICCARM__) */
 
 /* Exported variables --------------------------------------------------------*/
 OPENBL_MemoryTypeDef FLASH_Descriptor =
@@ -66,6 +139,19 @@ OPENBL_MemoryTypeDef FLASH_Descriptor =
 
 /* Exported functions --------------------------------------------------------*/
 
+/**
+  * @brief  Initialize the FLASH asynchronous programming.
+  * @note   The FLASH interrupt completes the queued program operations and the DWT cycle
+  *         counter, enabled by OpenBootloader_Init, measures the time spent by the FLASH and
+  *         the time waited for it.
+  * @retval None.
+  */
+void OPENBL_FLASH_Init(void)
+{
+  HAL_NVIC_SetPriority(FLASH_IRQn, 0U, 0U);
+  HAL_NVIC_EnableIRQ(FLASH_IRQn);
+}
+
 /**
   * @brief  Unlock the FLASH control register access.
   * @retval None.
@@ -102,11 +188,38 @@ void OPENBL_FLASH_OB_Unlock(void)
   */
 uint8_t OPENBL_FLASH_Read(uint32_t Address)
 {
-  return (*(uint8_t *)(Address));
+  uint8_t data;
+
+  /* Wait for the queued program operations */
+  OPENBL_FLASH_AsyncWait(0U);
+
+#if (FLASH_DELTA_MODE == 1U)
+  /* Complete the deferred erase operations before giving access to the FLASH content */
+  if (Flash_PendingPages != 0U)
+  {
+    OPENBL_FLASH_Complete();
+  }
+#endif /* (FLASH_DELTA_MODE == 1U) */
+
+  /* The staged bytes are read back without programming the double-word that they belong to */
+  if ((Flash_StagingAddress != FLASH_NO_STAGING)
+      && ((Address & ~((uint32_t)FLASH_PROG_STEP_SIZE - 1U)) == Flash_StagingAddress))
+  {
+    data = ((uint8_t *)Flash_StagingData)[Address - Flash_StagingAddress];
+  }
+  else
+  {
+    data = *(uint8_t *)(Address);
+  }
+
+  return data;
 }
 
 /**
   * @brief  This function is used to write data in FLASH memory.
+  * @note   The bytes that do not fill a complete double-word are staged until the next write
+  *         completes it, the staged double-word is programmed padded with 0xFF when the next
+  *         write is not contiguous or when the deferred operations are completed.
   * @param  Address The address where that data will be written.
   * @param  pData The data to be written.
   * @param  DataLength The length of the data to be written.
@@ -114,48 +227,66 @@ uint8_t OPENBL_FLASH_Read(uint32_t Address)
   */
 void OPENBL_FLASH_Write(uint32_t Address, uint8_t *pData, uint32_t DataLength)
 {
-  uint32_t index;
-  uint8_t remaining_data[FLASH_PROG_STEP_SIZE] = {0x0U};
-  uint8_t remaining;
+  uint32_t length;
+  uint8_t *p_staging = (uint8_t *)Flash_StagingData;
 
   if ((pData != NULL) && (DataLength != 0U))
   {
-    /* Unlock the flash memory for write operation */
-    OPENBL_FLASH_Unlock();
-
-    /* Program double-word by double-word (8 bytes) */
-    while ((DataLength >> 3U) > 0U)
+    /* Program the staged double-word if the data does not follow it */
+    if ((Flash_StagingAddress != FLASH_NO_STAGING) && (Address != Flash_StagingNext))
     {
-      OPENBL_FLASH_Program(Address, (uint64_t)(*((uint64_t *)((uint32_t)pData))));
-
-      Address    += FLASH_PROG_STEP_SIZE;
-      pData      += FLASH_PROG_STEP_SIZE;
-      DataLength -= FLASH_PROG_STEP_SIZE;
+      OPENBL_FLASH_StagingFlush();
     }
 
-    /* If remaining count, go back to fill the rest with 0xFF */
-    if (DataLength > 0U)
+    /* Complete the staged double-word or the unaligned head double-word */
+    if ((Flash_StagingAddress != FLASH_NO_STAGING) || ((Address % FLASH_PROG_STEP_SIZE) != 0U))
     {
-      remaining = FLASH_PROG_STEP_SIZE - DataLength;
-
-      /* Copy the remaining bytes */
-      for (index = 0U; index < DataLength; index++)
+      if (Flash_StagingAddress == FLASH_NO_STAGING)
       {
-        remaining_data[index] = *(pData + index);
+        OPENBL_FLASH_StagingOpen(Address);
       }
 
-      /* Fill the upper bytes with 0xFF */
-      for (index = 0U; index < remaining; index++)
+      do
+      {
+        p_staging[Address - Flash_StagingAddress] = *pData;
+
+        Address++;
+        pData++;
+        DataLength--;
+      } while ((DataLength > 0U) && ((Address % FLASH_PROG_STEP_SIZE) != 0U));
+
+      Flash_StagingNext = Address;
+
+      if ((Address % FLASH_PROG_STEP_SIZE) == 0U)
       {
-        remaining_data[index + DataLength] = 0xFFU;
+        OPENBL_FLASH_StagingFlush();
       }
+    }
+
+    /* Program the complete double-words */
+    length = DataLength & ~((uint32_t)FLASH_PROG_STEP_SIZE - 1U);
 
-      /* FLASH word program */
-      OPENBL_FLASH_Program(Address, (uint64_t)(*((uint64_t *)((uint32_t)remaining_data))));
+    if (length != 0U)
+    {
+      OPENBL_FLASH_WriteData(Address, pData, length);
+
+      Address    += length;
+      pData      += length;
+      DataLength -= length;
     }
 
-    /* Lock the Flash to disable the flash control register access */
-    OPENBL_FLASH_Lock();
+    /* Stage the tail bytes until the next write completes the double-word */
+    if (DataLength != 0U)
+    {
+      OPENBL_FLASH_StagingOpen(Address);
+
+      for (length = 0U; length < DataLength; length++)
+      {
+        p_staging[length] = pData[length];
+      }
+
+      Flash_StagingNext = Address + DataLength;
+    }
   }
 }
 
@@ -168,18 +299,25 @@ void OPENBL_FLASH_JumpToAddress(uint32_t Address)
 {
   Function_Pointer jump_to_address;
 
-  /* De-initialize all HW resources used by the Open Bootloader to their reset values */
-  OPENBL_DeInit();
+  /* Complete the deferred FLASH operations before leaving the Open Bootloader */
+  (void)OPENBL_FLASH_Flush();
+
+  /* Stay in the Open Bootloader if the digest of the image registered by the host does not match */
+  if (OPENBL_HASH_CheckImage() == SUCCESS)
+  {
+    /* De-initialize all HW resources used by the Open Bootloader to their reset values */
+    OPENBL_DeInit();
 
-  /* Enable IRQ */
-  Common_EnableIrq();
+    /* Enable IRQ */
+    Common_EnableIrq();
 
-  jump_to_address = (Function_Pointer)(*(__IO uint32_t *)(Address + 4U));
+    jump_to_address = (Function_Pointer)(*(__IO uint32_t *)(Address + 4U));
 
-  /* Initialize user application's stack pointer */
-  Common_SetMsp(*(__IO uint32_t *) Address);
+    /* Initialize user application's stack pointer */
+    Common_SetMsp(*(__IO uint32_t *) Address);
 
-  jump_to_address();
+    jump_to_address();
+  }
 }
 
 /**
@@ -213,6 +351,9 @@ void OPENBL_FLASH_SetReadOutProtectionLevel(uint32_t Level)
 
   if (Level != OB_RDP_LEVEL2)
   {
+    /* Complete the deferred FLASH operations before the option bytes loading */
+    (void)OPENBL_FLASH_Flush();
+
     flash_ob.OptionType = OPTIONBYTE_RDP;
     flash_ob.RDPLevel   = Level;
 
@@ -245,6 +386,9 @@ ErrorStatus OPENBL_FLASH_SetWriteProtection(FunctionalState State, uint8_t *List
 {
   ErrorStatus status = SUCCESS;
 
+  /* Complete the deferred FLASH operations before the option bytes loading */
+  (void)OPENBL_FLASH_Flush();
+
   if (State == ENABLE)
   {
     OPENBL_FLASH_EnableWriteProtection(ListOfPages, Length);
@@ -269,6 +413,8 @@ ErrorStatus OPENBL_FLASH_SetWriteProtection(FunctionalState State, uint8_t *List
 
 /**
   * @brief  This function is used to start FLASH mass erase operation.
+  * @note   The banks are selected as mapped: the bank 1 erase code erases the bank mapped at the
+  *         start of the FLASH and the bank 2 erase code the bank mapped in its upper half.
   * @param  *p_Data Pointer to the buffer that contains mass erase operation options.
   * @param  DataLength Size of the Data buffer.
   * @retval An ErrorStatus enumeration value:
@@ -281,6 +427,10 @@ ErrorStatus OPENBL_FLASH_MassErase(uint8_t *p_Data, uint32_t DataLength)
   ErrorStatus status   = SUCCESS;
   FLASH_EraseInitTypeDef erase_init_struct;
 
+  /* The erase is done synchronously once the staged and queued program operations are completed */
+  OPENBL_FLASH_StagingFlush();
+  OPENBL_FLASH_AsyncWait(0U);
+
   /* Unlock the flash memory for erase operation */
   OPENBL_FLASH_Unlock();
 
@@ -297,11 +447,11 @@ ErrorStatus OPENBL_FLASH_MassErase(uint8_t *p_Data, uint32_t DataLength)
     }
     else if (*(uint16_t *)(p_Data) == FLASH_BANK1_ERASE)
     {
-      erase_init_struct.Banks = FLASH_BANK_1;
+      erase_init_struct.Banks = (OPENBL_FLASH_GetPage(FLASH_START_ADDRESS) == 0U) ? FLASH_BANK_1 : FLASH_BANK_2;
     }
     else if (*(uint16_t *)(p_Data) == FLASH_BANK2_ERASE)
     {
-      erase_init_struct.Banks = FLASH_BANK_2;
+      erase_init_struct.Banks = (OPENBL_FLASH_GetPage(FLASH_START_ADDRESS) == 0U) ? FLASH_BANK_2 : FLASH_BANK_1;
     }
     else
     {
@@ -317,6 +467,22 @@ ErrorStatus OPENBL_FLASH_MassErase(uint8_t *p_Data, uint32_t DataLength)
       else
       {
         status = SUCCESS;
+
+#if (FLASH_DELTA_MODE == 1U)
+        /* The deferred erase operations of the erased banks are no longer needed */
+        if (erase_init_struct.Banks == FLASH_BANK_1)
+        {
+          OPENBL_FLASH_DeltaDiscard(0U, ((FLASH_PAGE_NUMBER / 2U) - 1U));
+        }
+        else if (erase_init_struct.Banks == FLASH_BANK_2)
+        {
+          OPENBL_FLASH_DeltaDiscard((FLASH_PAGE_NUMBER / 2U), (FLASH_PAGE_NUMBER - 1U));
+        }
+        else
+        {
+          OPENBL_FLASH_DeltaDiscard(0U, (FLASH_PAGE_NUMBER - 1U));
+        }
+#endif /* (FLASH_DELTA_MODE == 1U) */
       }
     }
   }
@@ -333,6 +499,8 @@ ErrorStatus OPENBL_FLASH_MassErase(uint8_t *p_Data, uint32_t DataLength)
 
 /**
   * @brief  This function is used to erase the specified FLASH pages.
+  * @note   The pages are numbered by address, page 0 is mapped at the start of the FLASH whatever
+  *         the swap state of the banks, as for the read and write operations.
   * @param  *p_Data Pointer to the buffer that contains erase operation options.
   * @param  DataLength Size of the Data buffer.
   * @retval An ErrorStatus enumeration value:
@@ -342,11 +510,15 @@ ErrorStatus OPENBL_FLASH_MassErase(uint8_t *p_Data, uint32_t DataLength)
 ErrorStatus OPENBL_FLASH_Erase(uint8_t *p_Data, uint32_t DataLength)
 {
   uint32_t counter;
+  uint32_t page;
   uint32_t pages_number;
-  uint32_t page_error   = 0U;
+  uint32_t pages_list[FLASH_PAGE_NUMBER / 32U] = {0U};
   uint32_t errors       = 0U;
   ErrorStatus status    = SUCCESS;
-  FLASH_EraseInitTypeDef erase_init_struct;
+
+  /* The erase is done synchronously once the staged and queued program operations are completed */
+  OPENBL_FLASH_StagingFlush();
+  OPENBL_FLASH_AsyncWait(0U);
 
   /* Unlock the flash memory for erase operation */
   OPENBL_FLASH_Unlock();
@@ -354,48 +526,39 @@ ErrorStatus OPENBL_FLASH_Erase(uint8_t *p_Data, uint32_t DataLength)
   /* Clear error programming flags */
   __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
 
+#if (FLASH_DELTA_MODE == 1U)
+  /* Complete the page being compared in differential mode before changing its erase state */
+  if (Flash_DeltaPage != FLASH_DELTA_NO_PAGE)
+  {
+    OPENBL_FLASH_DeltaClosePage();
+  }
+#endif /* (FLASH_DELTA_MODE == 1U) */
+
   pages_number  = (uint32_t)(*(uint16_t *)(p_Data));
 
   /* The sector number size is 2 bytes */
   p_Data += 2U;
 
-  erase_init_struct.TypeErase = FLASH_TYPEERASE_PAGES;
-  erase_init_struct.NbPages   = 1U;
-
+  /* Sort the list of pages and remove its duplicates, the invalid pages are ignored */
   for (counter = 0U; ((counter < pages_number) && (counter < (DataLength / 2U))) ; counter++)
   {
-    erase_init_struct.Page = ((uint32_t)(*(uint16_t *)(p_Data)));
+    page = ((uint32_t)(*(uint16_t *)(p_Data)));
 
-    if (erase_init_struct.Page <= ((FLASH_PAGE_NUMBER / 2U) - 1U))
-    {
-      erase_init_struct.Banks = FLASH_BANK_1;
-    }
-    else if (erase_init_struct.Page <= (FLASH_PAGE_NUMBER - 1U))
-    {
-      erase_init_struct.Banks = FLASH_BANK_2;
-    }
-    else
+    if (page < FLASH_PAGE_NUMBER)
     {
-      status = ERROR;
-    }
+      /* Translate the page mapped at this place to the page index of the FLASH controller */
+      page = OPENBL_FLASH_GetPage(FLASH_START_ADDRESS + (page * FLASH_PAGE_SIZE));
 
-    if (status != ERROR)
-    {
-      if (OPENBL_FLASH_ExtendedErase(&erase_init_struct, &page_error) != HAL_OK)
-      {
-        errors++;
-      }
-    }
-    else
-    {
-      /* Reset the status for next erase operation */
-      status = SUCCESS;
+      pages_list[page / 32U] |= (1UL << (page % 32U));
     }
 
     /* The page number size is 2 bytes */
     p_Data += 2U;
   }
 
+  errors += OPENBL_FLASH_EraseBankPages(pages_list, FLASH_BANK_1);
+  errors += OPENBL_FLASH_EraseBankPages(pages_list, FLASH_BANK_2);
+
   /* Lock the Flash to disable the flash control register access */
   OPENBL_FLASH_Lock();
 
@@ -432,171 +595,1147 @@ void OPENBL_Disable_BusyState_Flag(void)
   Flash_BusyState = FLASH_BUSY_STATE_DISABLED;
 }
 
-/* Private functions ---------------------------------------------------------*/
-
-/**
-  * @brief  Program double word at a specified FLASH address.
-  * @param  Address specifies the address to be programmed.
-  * @param  Data specifies the data to be programmed.
-  * @retval None.
-  */
-static void OPENBL_FLASH_Program(uint32_t Address, uint64_t Data)
-{
-  /* Clear all FLASH errors flags before starting write operation */
-  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
-
-  HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, Address, Data);
-}
-
 /**
-  * @brief  This function is used to enable write protection of the specified FLASH areas.
-  * @param  ListOfPages Contains the list of pages to be protected.
-  * @param  Length The length of the list of pages to be protected.
-  * @retval An ErrorStatus enumeration value:
-  *          - SUCCESS: Enable or disable of the write protection is done
-  *          - ERROR:   Enable or disable of the write protection is not done
+  * @brief  Read the FLASH statistics and optionally reset them.
+  * @note   The statistics are sent LSB first as 32-bit words:
+  *         - Number of page erase operations skipped because the pages were already blank
+  *         - CPU cycles during which the FLASH was programming queued data
+  *         - CPU cycles spent waiting for the queued program operations
+  *         - FLASH error flags of the program operations, bit 31 for a timeout
+  *         - CPU cycles spent programming the data written in synchronous or differential mode
+  *         - Number of bytes written in synchronous or differential mode
+  *         - Number of bytes written in asynchronous mode
+  * @param  pData Optional command byte, FLASH_STATS_RESET resets the statistics once read.
+  * @param  DataLength 0 or 1.
+  * @param  pStats The FLASH_STATS_SIZE bytes of statistics.
+  * @retval Returns SUCCESS if the command is valid else returns ERROR.
   */
-static ErrorStatus OPENBL_FLASH_EnableWriteProtection(uint8_t *ListOfPages, uint32_t Length)
+ErrorStatus OPENBL_FLASH_GetStatistics(uint8_t *pData, uint32_t DataLength, uint8_t *pStats)
 {
-  ErrorStatus status       = SUCCESS;
-  FLASH_OBProgramInitTypeDef flash_ob;
-
-  /* Unlock the FLASH registers & Option Bytes registers access */
-  OPENBL_FLASH_OB_Unlock();
-
-  /* Clear error programming flags */
-  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
-
-  flash_ob.OptionType = OPTIONBYTE_WRP;
+  ErrorStatus status = SUCCESS;
+  uint32_t stats[FLASH_STATS_SIZE / 4U];
+  uint32_t index;
 
-  /* Write protection of bank 1 area WRPA 1 area */
-  if (Length >= 2U)
+  if ((DataLength > 1U) || ((DataLength == 1U) && (pData[0] != FLASH_STATS_RESET)))
   {
-    flash_ob.WRPArea        = OB_WRPAREA_BANK1_AREAA;
-    flash_ob.WRPStartOffset = *(ListOfPages);
-    flash_ob.WRPEndOffset   = *(ListOfPages + 1U);
-
-    HAL_FLASHEx_OBProgram(&flash_ob);
+    status = ERROR;
   }
-
-  /* Write protection of bank 1 area WRPA 2 area */
-  if (Length >= 4U)
+  else
   {
-    flash_ob.WRPArea        = OB_WRPAREA_BANK1_AREAB;
-    flash_ob.WRPStartOffset = *(ListOfPages + 2U);
-    flash_ob.WRPEndOffset   = *(ListOfPages + 3U);
+    stats[0] = Flash_SkippedErases;
+    stats[1] = Flash_BusyCycles;
+    stats[2] = Flash_StallCycles;
+    stats[3] = Flash_ErrorFlags | Flash_ProgramError;
+    stats[4] = Flash_SyncCycles;
+    stats[5] = Flash_SyncBytes;
+    stats[6] = Flash_AsyncBytes;
+
+    for (index = 0U; index < FLASH_STATS_SIZE; index++)
+    {
+      pStats[index] = (uint8_t)((stats[index / 4U] >> (8U * (index % 4U))) & 0xFFU);
+    }
 
-    HAL_FLASHEx_OBProgram(&flash_ob);
+    if (DataLength == 1U)
+    {
+      Flash_SkippedErases = 0U;
+      Flash_BusyCycles    = 0U;
+      Flash_StallCycles   = 0U;
+      Flash_ErrorFlags    = 0U;
+      Flash_SyncCycles    = 0U;
+      Flash_SyncBytes     = 0U;
+      Flash_AsyncBytes    = 0U;
+    }
   }
 
-  /* Write protection of bank 2 area WRPB 1 area */
-  if (Length >= 6U)
-  {
-    flash_ob.WRPArea        = OB_WRPAREA_BANK2_AREAA;
-    flash_ob.WRPStartOffset = *(ListOfPages + 4U);
-    flash_ob.WRPEndOffset   = *(ListOfPages + 5U);
+  return status;
+}
 
-    HAL_FLASHEx_OBProgram(&flash_ob);
-  }
+/**
+  * @brief  Complete the deferred FLASH operations and report the program errors.
+  * @note   The errors of the program operations completed since the previous call are reported
+  *         once, they are also kept in the FLASH statistics.
+  * @retval Returns SUCCESS if the data is programmed without error else returns ERROR.
+  */
+ErrorStatus OPENBL_FLASH_Flush(void)
+{
+  ErrorStatus status = SUCCESS;
 
-  /* Write protection of bank 2 area WRPB 2 area */
-  if (Length >= 8U)
+  OPENBL_FLASH_Complete();
+
+  if (Flash_ProgramError != 0U)
   {
-    flash_ob.WRPArea        = OB_WRPAREA_BANK2_AREAB;
-    flash_ob.WRPStartOffset = *(ListOfPages + 6U);
-    flash_ob.WRPEndOffset   = *(ListOfPages + 7U);
+    Flash_ErrorFlags  |= Flash_ProgramError;
+    Flash_ProgramError = 0U;
 
-    HAL_FLASHEx_OBProgram(&flash_ob);
+    status = ERROR;
   }
 
   return status;
 }
 
 /**
-  * @brief  This function is used to disable write protection.
+  * @brief  Swap the FLASH banks to run the image programmed in the inactive bank.
+  * @note   Whatever the swap state, the inactive bank is mapped in the upper half of the FLASH
+  *         and can be programmed while the Open Bootloader runs from the active bank.
+  *         The swap is effective after the option bytes loading, swapping again rolls back
+  *         to the previous image.
+  * @param  pData Optional image size and expected CRC32 (4 bytes each, LSB first).
+  * @param  DataLength 0 to only check the vector table of the image, 8 to also check its CRC32.
   * @retval An ErrorStatus enumeration value:
-  *          - SUCCESS: Enable or disable of the write protection is done
-  *          - ERROR:   Enable or disable of the write protection is not done
+  *          - SUCCESS: The swap is programmed in the option bytes
+  *          - ERROR:   Single bank mode, program error or the image of the inactive bank is not valid
   */
-static ErrorStatus OPENBL_FLASH_DisableWriteProtection(void)
+ErrorStatus OPENBL_FLASH_SwapBank(uint8_t *pData, uint32_t DataLength)
 {
-  ErrorStatus status       = SUCCESS;
+  ErrorStatus status = SUCCESS;
   FLASH_OBProgramInitTypeDef flash_ob;
 
-  /* Unlock the FLASH registers & Option Bytes registers access */
-  OPENBL_FLASH_OB_Unlock();
-
-  /* Clear error programming flags */
-  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
-
-  flash_ob.OptionType = OPTIONBYTE_WRP;
-
-  /* Disable write protection of bank 1 area WRPA 1 area */
-  flash_ob.WRPArea        = OB_WRPAREA_BANK1_AREAA;
-  flash_ob.WRPStartOffset = FLASH_PAGE_MAX_NUMBER;
-  flash_ob.WRPEndOffset   = 0x00U;
+  /* Complete the deferred FLASH operations before checking the image */
+  if (OPENBL_FLASH_Flush() != SUCCESS)
+  {
+    status = ERROR;
+  }
+  else if (READ_BIT(FLASH->OPTR, FLASH_OPTR_DBANK) == 0U)
+  {
+    status = ERROR;
+  }
+  else if (OPENBL_FLASH_CheckInactiveBank(pData, DataLength) != SUCCESS)
+  {
+    status = ERROR;
+  }
+  else
+  {
+    flash_ob.OptionType = OPTIONBYTE_USER;
+    flash_ob.USERType   = OB_USER_SWAP_BANK;
 
-  HAL_FLASHEx_OBProgram(&flash_ob);
+    if (READ_BIT(FLASH->OPTR, FLASH_OPTR_SWAP_BANK) == 0U)
+    {
+      flash_ob.USERConfig = OB_SWAP_BANK_ENABLE;
+    }
+    else
+    {
+      flash_ob.USERConfig = OB_SWAP_BANK_DISABLE;
+    }
 
-  /* Disable write protection of bank 1 area WRPA 2 area */
-  flash_ob.WRPArea        = OB_WRPAREA_BANK1_AREAB;
-  flash_ob.WRPStartOffset = FLASH_PAGE_MAX_NUMBER;
-  flash_ob.WRPEndOffset   = 0x00U;
+    /* Unlock the FLASH registers & Option Bytes registers access */
+    OPENBL_FLASH_OB_Unlock();
 
-  HAL_FLASHEx_OBProgram(&flash_ob);
+    /* Clear error programming flags */
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
 
-  /* Disable write protection of bank 2 area WRPB 1 area */
-  flash_ob.WRPArea        = OB_WRPAREA_BANK2_AREAA;
-  flash_ob.WRPStartOffset = FLASH_PAGE_MAX_NUMBER;
-  flash_ob.WRPEndOffset   = 0x00U;
+    if (HAL_FLASHEx_OBProgram(&flash_ob) != HAL_OK)
+    {
+      status = ERROR;
+    }
+    else
+    {
+      /* Register system reset callback */
+      Common_SetPostProcessingCallback(OPENBL_OB_Launch);
+    }
+  }
 
-  HAL_FLASHEx_OBProgram(&flash_ob);
+  return status;
+}
 
-  /* Disable write protection of bank 2 area WRPB 2 area */
-  flash_ob.WRPArea        = OB_WRPAREA_BANK2_AREAB;
-  flash_ob.WRPStartOffset = FLASH_PAGE_MAX_NUMBER;
-  flash_ob.WRPEndOffset   = 0x00U;
+/* Private functions ---------------------------------------------------------*/
 
-  HAL_FLASHEx_OBProgram(&flash_ob);
+/**
+  * @brief  Program double word at a specified FLASH address.
+  * @param  Address specifies the address to be programmed.
+  * @param  Data specifies the data to be programmed.
+  * @retval HAL_Status
+  */
+static HAL_StatusTypeDef OPENBL_FLASH_Program(uint32_t Address, uint64_t Data)
+{
+  /* Clear all FLASH errors flags before starting write operation */
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
 
-  return status;
+  return HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, Address, Data);
 }
 
 /**
-  * @brief  Wait for a FLASH operation to complete.
-  * @param  Timeout maximum flash operation timeout.
-  * @retval HAL_Status
+  * @brief  Program data in FLASH memory, the FLASH must be unlocked.
+  * @note   The programming stops at the first error, which is reported by OPENBL_FLASH_Flush.
+  * @param  Address The address where that data will be written.
+  * @param  pData The data to be written.
+  * @param  DataLength The length of the data to be written.
+  * @retval None.
   */
-#if defined (__ICCARM__)
-__ramfunc HAL_StatusTypeDef OPENBL_FLASH_WaitForLastOperation(uint32_t Timeout)
-#else
-__attribute__((section(".ramfunc"))) HAL_StatusTypeDef OPENBL_FLASH_WaitForLastOperation(uint32_t Timeout)
-#endif /* (__ICCARM__) */
+static void OPENBL_FLASH_ProgramData(uint32_t Address, uint8_t *pData, uint32_t DataLength)
 {
-  uint32_t tick = 0;
-  uint32_t error;
-  __IO uint32_t *reg_sr;
+  uint32_t index;
+  uint32_t step;
+  uint32_t error = 0U;
+  uint8_t remaining_data[FLASH_PROG_STEP_SIZE] = {0x0U};
+  uint8_t remaining;
   HAL_StatusTypeDef status = HAL_OK;
 
-  /* While the FLASH is in busy state, send busy byte to the host */
-  while (__HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY))
+  while (((DataLength >> 3U) > 0U) && (status == HAL_OK))
   {
-    /* Check if we need to send a busy byte
-       NOTE: this can be removed if I2C protocol is not used */
-    if (Flash_BusyState == FLASH_BUSY_STATE_ENABLED)
+    if (((Address & (FLASH_ROW_SIZE - 1U)) == 0U) && (DataLength >= FLASH_ROW_SIZE))
     {
-      OPENBL_I2C_SendBusyByte();
-    }
+      /* Program a whole row (256 bytes) in a single programming sequence */
+      status = OPENBL_FLASH_ProgramRow(Address, pData, FLASH_ROW_SIZE);
+      error  = FlashProcess.ErrorCode;
 
-    if (tick++ > Timeout)
+      step = FLASH_ROW_SIZE;
+    }
+    else
     {
-      status = HAL_TIMEOUT;
-      break;
+      /* Program double-word by double-word (8 bytes) partial rows */
+      status = OPENBL_FLASH_Program(Address, (uint64_t)(*((uint64_t *)((uint32_t)pData))));
+      error  = HAL_FLASH_GetError();
+
+      step = FLASH_PROG_STEP_SIZE;
     }
+
+    Address    += step;
+    pData      += step;
+    DataLength -= step;
   }
 
-  /* Access to SECSR or NSSR registers depends on operation type */
-  reg_sr = IS_FLASH_SECURE_OPERATION() ? &(FLASH->SECSR) : &(FLASH_NS->NSSR);
+  /* If remaining count, go back to fill the rest with 0xFF */
+  if ((DataLength > 0U) && (status == HAL_OK))
+  {
+    remaining = FLASH_PROG_STEP_SIZE - DataLength;
+
+    /* Copy the remaining bytes */
+    for (index = 0U; index < DataLength; index++)
+    {
+      remaining_data[index] = *(pData + index);
+    }
+
+    /* Fill the upper bytes with 0xFF */
+    for (index = 0U; index < remaining; index++)
+    {
+      remaining_data[index + DataLength] = 0xFFU;
+    }
+
+    /* FLASH word program */
+    status = OPENBL_FLASH_Program(Address, (uint64_t)(*((uint64_t *)((uint32_t)remaining_data))));
+    error  = HAL_FLASH_GetError();
+  }
+
+  if (status != HAL_OK)
+  {
+    OPENBL_FLASH_SaveProgramError(error);
+  }
+}
+
+/**
+  * @brief  Write complete double-words in FLASH memory with the selected programming mode.
+  * @param  Address The address where that data will be written, double-word aligned.
+  * @param  pData The data to be written.
+  * @param  DataLength The length of the data to be written, multiple of a double-word.
+  * @retval None.
+  */
+static void OPENBL_FLASH_WriteData(uint32_t Address, uint8_t *pData, uint32_t DataLength)
+{
+  uint32_t start;
+
+  if ((Flash_AsyncMode == ENABLE) && (FLASH_DELTA_MODE == 0U))
+  {
+    /* The FLASH is unlocked when the jobs are queued and locked when they are completed */
+    OPENBL_FLASH_AsyncWrite(Address, pData, DataLength);
+
+    Flash_AsyncBytes += DataLength;
+  }
+  else
+  {
+    /* Wait for the queued program operations */
+    OPENBL_FLASH_AsyncWait(0U);
+
+    start = DWT->CYCCNT;
+
+    /* Unlock the flash memory for write operation */
+    OPENBL_FLASH_Unlock();
+
+#if (FLASH_DELTA_MODE == 1U)
+    OPENBL_FLASH_DeltaWrite(Address, pData, DataLength);
+#else
+    OPENBL_FLASH_ProgramData(Address, pData, DataLength);
+#endif /* (FLASH_DELTA_MODE == 1U) */
+
+    /* Lock the Flash to disable the flash control register access */
+    OPENBL_FLASH_Lock();
+
+    Flash_SyncCycles += DWT->CYCCNT - start;
+    Flash_SyncBytes  += DataLength;
+  }
+}
+
+/**
+  * @brief  Start staging the double-word containing an address, its bytes are set to 0xFF.
+  * @param  Address The address of the first staged byte.
+  * @retval None.
+  */
+static void OPENBL_FLASH_StagingOpen(uint32_t Address)
+{
+  Flash_StagingAddress  = Address & ~((uint32_t)FLASH_PROG_STEP_SIZE - 1U);
+  Flash_StagingData[0U] = 0xFFFFFFFFU;
+  Flash_StagingData[1U] = 0xFFFFFFFFU;
+}
+
+/**
+  * @brief  Program the staged double-word, the bytes that were not written stay at 0xFF.
+  * @retval None.
+  */
+static void OPENBL_FLASH_StagingFlush(void)
+{
+  uint32_t address = Flash_StagingAddress;
+
+  if (address != FLASH_NO_STAGING)
+  {
+    Flash_StagingAddress = FLASH_NO_STAGING;
+
+    OPENBL_FLASH_WriteData(address, (uint8_t *)Flash_StagingData, FLASH_PROG_STEP_SIZE);
+  }
+}
+
+/**
+  * @brief  Complete the deferred FLASH operations.
+  * @note   The staged double-word is programmed and the queued program operations are completed,
+  *         then the page being compared in differential mode is completed and the pending pages
+  *         that were not written are erased.
+  * @retval None.
+  */
+static void OPENBL_FLASH_Complete(void)
+{
+#if (FLASH_DELTA_MODE == 1U)
+  uint32_t page;
+#endif /* (FLASH_DELTA_MODE == 1U) */
+
+  OPENBL_FLASH_StagingFlush();
+  OPENBL_FLASH_AsyncWait(0U);
+
+#if (FLASH_DELTA_MODE == 1U)
+  if (Flash_PendingPages != 0U)
+  {
+    /* Unlock the flash memory for erase operation */
+    OPENBL_FLASH_Unlock();
+
+    if (Flash_DeltaPage != FLASH_DELTA_NO_PAGE)
+    {
+      OPENBL_FLASH_DeltaClosePage();
+    }
+
+    for (page = 0U; page < FLASH_PAGE_NUMBER; page++)
+    {
+      if ((Flash_PendingErase[page / 32U] & (1UL << (page % 32U))) != 0U)
+      {
+        (void)OPENBL_FLASH_ErasePage(page);
+      }
+    }
+
+    OPENBL_FLASH_DeltaDiscard(0U, (FLASH_PAGE_NUMBER - 1U));
+
+    /* Lock the Flash to disable the flash control register access */
+    OPENBL_FLASH_Lock();
+  }
+#endif /* (FLASH_DELTA_MODE == 1U) */
+}
+
+/**
+  * @brief  Save the error of a FLASH operation to be reported by OPENBL_FLASH_Flush.
+  * @param  ErrorCode The FLASH error flags of the operation, 0 if it was not completed in time.
+  * @retval None.
+  */
+static void OPENBL_FLASH_SaveProgramError(uint32_t ErrorCode)
+{
+  Flash_ProgramError |= (ErrorCode != 0U) ? ErrorCode : FLASH_ERROR_TIMEOUT;
+}
+
+/**
+  * @brief  Return the index of the page holding an address.
+  * @note   The pages are indexed as erased by the FLASH controller: the pages of the bank 1
+  *         come first, then the pages of the bank 2. When the banks are swapped, the bank 2
+  *         is mapped at the start of the FLASH and the bank 1 in its upper half.
+  * @param  Address An address of the FLASH.
+  * @retval The index of the page.
+  */
+static uint32_t OPENBL_FLASH_GetPage(uint32_t Address)
+{
+  uint32_t page = (Address - FLASH_START_ADDRESS) / FLASH_PAGE_SIZE;
+
+  if (READ_BIT(FLASH->OPTR, FLASH_OPTR_SWAP_BANK) != 0U)
+  {
+    page = (page + FLASH_BANK_PAGE_NUMBER) % FLASH_PAGE_NUMBER;
+  }
+
+  return page;
+}
+
+/**
+  * @brief  Return the address where a page is mapped, according to the swap state of the banks.
+  * @param  Page Index of the page, see OPENBL_FLASH_GetPage().
+  * @retval The start address of the page.
+  */
+static uint32_t OPENBL_FLASH_GetPageAddress(uint32_t Page)
+{
+  uint32_t page = Page;
+
+  if (READ_BIT(FLASH->OPTR, FLASH_OPTR_SWAP_BANK) != 0U)
+  {
+    page = (page + FLASH_BANK_PAGE_NUMBER) % FLASH_PAGE_NUMBER;
+  }
+
+  return FLASH_START_ADDRESS + (page * FLASH_PAGE_SIZE);
+}
+
+#if (FLASH_DELTA_MODE == 1U)
+
+/**
+  * @brief  Erase one FLASH page, the FLASH must be unlocked.
+  * @param  Page Index of the page to be erased.
+  * @retval HAL_Status
+  */
+static HAL_StatusTypeDef OPENBL_FLASH_ErasePage(uint32_t Page)
+{
+  uint32_t page_error = 0U;
+  FLASH_EraseInitTypeDef erase_init_struct;
+
+  erase_init_struct.TypeErase = FLASH_TYPEERASE_PAGES;
+  erase_init_struct.Page      = Page % FLASH_BANK_PAGE_NUMBER;
+  erase_init_struct.NbPages   = 1U;
+
+  if (Page < FLASH_BANK_PAGE_NUMBER)
+  {
+    erase_init_struct.Banks = FLASH_BANK_1;
+  }
+  else
+  {
+    erase_init_struct.Banks = FLASH_BANK_2;
+  }
+
+  /* Clear error programming flags */
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+
+  return OPENBL_FLASH_ExtendedErase(&erase_init_struct, &page_error);
+}
+
+/**
+  * @brief  Write data in FLASH memory in differential mode, the FLASH must be unlocked.
+  * @note   In the pages whose erase is pending, the data is compared with the FLASH content
+  *         and the page is only erased and reprogrammed when they differ.
+  * @param  Address The address where that data will be written.
+  * @param  pData The data to be written.
+  * @param  DataLength The length of the data to be written.
+  * @retval None.
+  */
+static void OPENBL_FLASH_DeltaWrite(uint32_t Address, uint8_t *pData, uint32_t DataLength)
+{
+  uint32_t page;
+  uint32_t length;
+  uint32_t index;
+  uint32_t offset;
+
+  while (DataLength > 0U)
+  {
+    /* Split the data on page boundaries */
+    offset = (Address - FLASH_START_ADDRESS) % FLASH_PAGE_SIZE;
+    page   = OPENBL_FLASH_GetPage(Address);
+    length = FLASH_PAGE_SIZE - offset;
+
+    if (length > DataLength)
+    {
+      length = DataLength;
+    }
+
+    /* Complete the page that was being compared before moving to another one */
+    if ((Flash_DeltaPage != FLASH_DELTA_NO_PAGE) && (Flash_DeltaPage != page))
+    {
+      OPENBL_FLASH_DeltaClosePage();
+    }
+
+    if ((Flash_PendingErase[page / 32U] & (1UL << (page % 32U))) == 0U)
+    {
+      /* The page is already erased, program it as usual */
+      OPENBL_FLASH_ProgramData(Address, pData, length);
+    }
+    else
+    {
+      if (Flash_DeltaPage != page)
+      {
+        Flash_DeltaPage = page;
+
+        for (index = 0U; index < (FLASH_PAGE_DWORDS / 32U); index++)
+        {
+          Flash_DeltaWritten[index] = 0U;
+        }
+      }
+
+      if (OPENBL_FLASH_DeltaCompare(Address, pData, length) == SET)
+      {
+        /* Same content in FLASH, only record the written double-words */
+        for (index = (offset / FLASH_PROG_STEP_SIZE); index <= ((offset + length - 1U) / FLASH_PROG_STEP_SIZE);
+             index++)
+        {
+          Flash_DeltaWritten[index / 32U] |= (1UL << (index % 32U));
+        }
+      }
+      else
+      {
+        OPENBL_FLASH_DeltaRewritePage(Address, pData, length);
+      }
+    }
+
+    Address    += length;
+    pData      += length;
+    DataLength -= length;
+  }
+}
+
+/**
+  * @brief  Compare data with the FLASH content, trailing bytes of the last double-word
+  *         are compared with the 0xFF padding used when programming it.
+  * @param  Address The FLASH address to be compared.
+  * @param  pData The data to be compared.
+  * @param  DataLength The length of the data to be compared.
+  * @retval Returns SET if the FLASH already contains the data else returns RESET.
+  */
+static FlagStatus OPENBL_FLASH_DeltaCompare(uint32_t Address, uint8_t *pData, uint32_t DataLength)
+{
+  uint32_t index;
+  FlagStatus status = SET;
+
+  for (index = 0U; ((index < DataLength) && (status == SET)); index++)
+  {
+    if (*(uint8_t *)(Address + index) != pData[index])
+    {
+      status = RESET;
+    }
+  }
+
+  for (; (((index % FLASH_PROG_STEP_SIZE) != 0U) && (status == SET)); index++)
+  {
+    if (*(uint8_t *)(Address + index) != 0xFFU)
+    {
+      status = RESET;
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Erase and reprogram the page being compared with its expected content: the
+  *         double-words already written by the host, the new data and 0xFF elsewhere.
+  * @param  Address The address where the new data will be written.
+  * @param  pData The new data to be written, can be NULL when there is no new data.
+  * @param  DataLength The length of the new data.
+  * @retval None.
+  */
+static void OPENBL_FLASH_DeltaRewritePage(uint32_t Address, uint8_t *pData, uint32_t DataLength)
+{
+  uint32_t index;
+  uint32_t start;
+  uint32_t page_address = OPENBL_FLASH_GetPageAddress(Flash_DeltaPage);
+  uint8_t *p_buffer     = (uint8_t *)Flash_PageBuffer;
+
+  /* Keep the double-words already written by the host, the rest of the page is erased */
+  for (index = 0U; index < FLASH_PAGE_DWORDS; index++)
+  {
+    if ((Flash_DeltaWritten[index / 32U] & (1UL << (index % 32U))) != 0U)
+    {
+      Flash_PageBuffer[2U * index]        = *(uint32_t *)(page_address + (index * FLASH_PROG_STEP_SIZE));
+      Flash_PageBuffer[(2U * index) + 1U] = *(uint32_t *)(page_address + (index * FLASH_PROG_STEP_SIZE) + 4U);
+    }
+    else
+    {
+      Flash_PageBuffer[2U * index]        = 0xFFFFFFFFU;
+      Flash_PageBuffer[(2U * index) + 1U] = 0xFFFFFFFFU;
+    }
+  }
+
+  /* Merge the new data */
+  for (index = 0U; index < DataLength; index++)
+  {
+    p_buffer[(Address - page_address) + index] = pData[index];
+  }
+
+  if (OPENBL_FLASH_ErasePage(Flash_DeltaPage) != HAL_OK)
+  {
+    OPENBL_FLASH_SaveProgramError(FlashProcess.ErrorCode);
+  }
+  else
+  {
+    /* Program the runs of double-words that are not blank, blank ones are left erased */
+    index = 0U;
+
+    while (index < FLASH_PAGE_DWORDS)
+    {
+      while ((index < FLASH_PAGE_DWORDS)
+             && ((Flash_PageBuffer[2U * index] & Flash_PageBuffer[(2U * index) + 1U]) == 0xFFFFFFFFU))
+      {
+        index++;
+      }
+
+      start = index;
+
+      while ((index < FLASH_PAGE_DWORDS)
+             && ((Flash_PageBuffer[2U * index] & Flash_PageBuffer[(2U * index) + 1U]) != 0xFFFFFFFFU))
+      {
+        index++;
+      }
+
+      if (index > start)
+      {
+        if (OPENBL_FLASH_ProgramRow(page_address + (start * FLASH_PROG_STEP_SIZE),
+                                    &p_buffer[start * FLASH_PROG_STEP_SIZE],
+                                    (index - start) * FLASH_PROG_STEP_SIZE) != HAL_OK)
+        {
+          OPENBL_FLASH_SaveProgramError(FlashProcess.ErrorCode);
+        }
+      }
+    }
+  }
+
+  /* The page is now up to date */
+  Flash_PendingErase[Flash_DeltaPage / 32U] &= ~(1UL << (Flash_DeltaPage % 32U));
+  Flash_PendingPages--;
+  Flash_DeltaPage = FLASH_DELTA_NO_PAGE;
+}
+
+/**
+  * @brief  Complete the page being compared: it is left untouched if the double-words that
+  *         were not written by the host are blank, otherwise it is rewritten.
+  * @retval None.
+  */
+static void OPENBL_FLASH_DeltaClosePage(void)
+{
+  uint32_t index;
+  uint32_t address;
+  uint32_t page_address = OPENBL_FLASH_GetPageAddress(Flash_DeltaPage);
+  FlagStatus blank      = SET;
+
+  for (index = 0U; ((index < FLASH_PAGE_DWORDS) && (blank == SET)); index++)
+  {
+    address = page_address + (index * FLASH_PROG_STEP_SIZE);
+
+    if (((Flash_DeltaWritten[index / 32U] & (1UL << (index % 32U))) == 0U)
+        && ((*(uint32_t *)address & *(uint32_t *)(address + 4U)) != 0xFFFFFFFFU))
+    {
+      blank = RESET;
+    }
+  }
+
+  if (blank == SET)
+  {
+    /* The FLASH already holds the expected content, the erase is not needed */
+    Flash_PendingErase[Flash_DeltaPage / 32U] &= ~(1UL << (Flash_DeltaPage % 32U));
+    Flash_PendingPages--;
+    Flash_DeltaPage = FLASH_DELTA_NO_PAGE;
+    Flash_SkippedErases++;
+  }
+  else
+  {
+    OPENBL_FLASH_DeltaRewritePage(page_address, NULL, 0U);
+  }
+}
+
+/**
+  * @brief  Forget the deferred erase operations of a range of pages.
+  * @param  FirstPage Index of the first page of the range.
+  * @param  LastPage Index of the last page of the range.
+  * @retval None.
+  */
+static void OPENBL_FLASH_DeltaDiscard(uint32_t FirstPage, uint32_t LastPage)
+{
+  uint32_t page;
+
+  if ((Flash_DeltaPage >= FirstPage) && (Flash_DeltaPage <= LastPage))
+  {
+    Flash_DeltaPage = FLASH_DELTA_NO_PAGE;
+  }
+
+  for (page = FirstPage; page <= LastPage; page++)
+  {
+    if ((Flash_PendingErase[page / 32U] & (1UL << (page % 32U))) != 0U)
+    {
+      Flash_PendingErase[page / 32U] &= ~(1UL << (page % 32U));
+      Flash_PendingPages--;
+    }
+  }
+}
+#endif /* (FLASH_DELTA_MODE == 1U) */
+
+/**
+  * @brief  Queue data to be programmed in FLASH memory under FLASH interrupt.
+  * @param  Address The address where that data will be written.
+  * @param  pData The data to be written.
+  * @param  DataLength The length of the data to be written.
+  * @retval None.
+  */
+static void OPENBL_FLASH_AsyncWrite(uint32_t Address, uint8_t *pData, uint32_t DataLength)
+{
+  uint32_t index;
+  uint32_t length;
+  uint32_t primask;
+  uint8_t *p_buffer;
+  OPENBL_FLASH_JobTypeDef *p_job;
+
+  while (DataLength > 0U)
+  {
+    /* Wait for a free job buffer */
+    OPENBL_FLASH_AsyncWait(FLASH_ASYNC_JOBS - 1U);
+
+    p_job    = &Flash_Jobs[Flash_JobsTail];
+    p_buffer = (uint8_t *)p_job->Data;
+    length   = (DataLength > FLASH_ROW_SIZE) ? FLASH_ROW_SIZE : DataLength;
+
+    for (index = 0U; index < length; index++)
+    {
+      p_buffer[index] = pData[index];
+    }
+
+    /* Fill the upper bytes of the last double-word with 0xFF */
+    for (; (index % FLASH_PROG_STEP_SIZE) != 0U; index++)
+    {
+      p_buffer[index] = 0xFFU;
+    }
+
+    p_job->Address = Address;
+    p_job->Length  = index;
+    p_job->Index   = 0U;
+
+    Flash_JobsTail = (Flash_JobsTail + 1U) % FLASH_ASYNC_JOBS;
+
+    /* Queue the job, the FLASH interrupt starts it if a job is already on going */
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    Flash_JobsCount++;
+
+    if (Flash_JobsCount == 1U)
+    {
+      /* Unlock the flash memory for write operation */
+      OPENBL_FLASH_Unlock();
+
+      /* Clear all FLASH errors flags before starting write operation */
+      __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+
+      OPENBL_FLASH_AsyncStartJob(p_job);
+    }
+
+    __set_PRIMASK(primask);
+
+    Address    += length;
+    pData      += length;
+    DataLength -= length;
+  }
+}
+
+/**
+  * @brief  Wait until the number of queued program operations is lower or equal to a given value.
+  * @note   The queued jobs are aborted and a program error is reported if the FLASH does not
+  *         complete them within PROGRAM_TIMEOUT.
+  * @param  MaxJobs The maximum number of jobs left in the queue.
+  * @retval None.
+  */
+static void OPENBL_FLASH_AsyncWait(uint32_t MaxJobs)
+{
+  uint32_t start;
+  uint32_t deadline;
+  uint32_t primask;
+  __IO uint32_t *reg_cr;
+
+  if (Flash_JobsCount > MaxJobs)
+  {
+    start    = DWT->CYCCNT;
+    deadline = Common_StartTimeout(PROGRAM_TIMEOUT);
+
+    while (Flash_JobsCount > MaxJobs)
+    {
+      OPENBL_IWDG_Refresh();
+
+      /* Check if we need to send a busy byte
+         NOTE: this can be removed if I2C protocol is not used */
+      if (Flash_BusyState == FLASH_BUSY_STATE_ENABLED)
+      {
+        OPENBL_I2C_SendBusyByte();
+      }
+
+      if (Common_IsTimeoutElapsed(deadline) == SET)
+      {
+        primask = __get_PRIMASK();
+        __disable_irq();
+
+        /* Access to SECCR or NSCR registers depends on operation type */
+        reg_cr = IS_FLASH_SECURE_OPERATION() ? &(FLASH->SECCR) : &(FLASH_NS->NSCR);
+
+        /* Disable PG bit and interrupts, lock the Flash and drop the queued jobs */
+        CLEAR_BIT((*reg_cr), (FLASH_NSCR_NSPG | FLASH_NSCR_NSEOPIE | FLASH_NSCR_NSERRIE));
+        SET_BIT((*reg_cr), FLASH_NSCR_NSLOCK);
+
+        Flash_JobsHead      = Flash_JobsTail;
+        Flash_JobsCount     = 0U;
+        Flash_ProgramError |= FLASH_ERROR_TIMEOUT;
+
+        __set_PRIMASK(primask);
+      }
+    }
+
+    Flash_StallCycles += DWT->CYCCNT - start;
+  }
+}
+
+/**
+  * @brief  Check the image programmed in the inactive bank before swapping the banks.
+  * @note   The stack pointer must be in RAM and the reset handler must be a Thumb address
+  *         of the bank once swapped.
+  * @param  pData Optional image size and expected CRC32 (4 bytes each, LSB first).
+  * @param  DataLength 0 to only check the vector table of the image, 8 to also check its CRC32.
+  * @retval Returns SUCCESS if the image is valid else returns ERROR.
+  */
+static ErrorStatus OPENBL_FLASH_CheckInactiveBank(uint8_t *pData, uint32_t DataLength)
+{
+  uint32_t stack_pointer = *(uint32_t *)(FLASH_INACTIVE_BANK_ADDRESS);
+  uint32_t reset_handler = *(uint32_t *)(FLASH_INACTIVE_BANK_ADDRESS + 4U);
+  uint32_t size;
+  uint32_t crc;
+  uint32_t image_crc = 0U;
+  ErrorStatus status = SUCCESS;
+
+  if ((stack_pointer <= RAM_START_ADDRESS) || (stack_pointer > RAM_END_ADDRESS))
+  {
+    status = ERROR;
+  }
+  else if (((reset_handler & 0x1U) == 0U) || (reset_handler < FLASH_START_ADDRESS)
+           || (reset_handler >= FLASH_INACTIVE_BANK_ADDRESS))
+  {
+    status = ERROR;
+  }
+  else if (DataLength == 8U)
+  {
+    size = (uint32_t)pData[0] | ((uint32_t)pData[1] << 8U) | ((uint32_t)pData[2] << 16U) | ((uint32_t)pData[3] << 24U);
+    crc  = (uint32_t)pData[4] | ((uint32_t)pData[5] << 8U) | ((uint32_t)pData[6] << 16U) | ((uint32_t)pData[7] << 24U);
+
+    if ((size == 0U) || (size > FLASH_BANK_SIZE)
+        || (OPENBL_CRC_Compute(FLASH_INACTIVE_BANK_ADDRESS, size, &image_crc) != SUCCESS)
+        || (image_crc != crc))
+    {
+      status = ERROR;
+    }
+  }
+  else if (DataLength != 0U)
+  {
+    status = ERROR;
+  }
+  else
+  {
+    /* Only the vector table is checked */
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Erase the pages of a bank selected in a list of pages, the FLASH must be unlocked.
+  * @note   The consecutive pages are erased by runs, blank pages are skipped and the bank
+  *         is mass erased when all its pages are selected and it is not write protected.
+  * @param  pPagesList Bitmap of the selected pages, one bit per page of the FLASH.
+  * @param  Bank The bank to be erased, FLASH_BANK_1 or FLASH_BANK_2.
+  * @retval The number of failed erase operations.
+  */
+static uint32_t OPENBL_FLASH_EraseBankPages(uint32_t *pPagesList, uint32_t Bank)
+{
+  uint32_t page;
+  uint32_t first_page;
+  uint32_t selected   = 0U;
+  uint32_t page_error = 0U;
+  uint32_t errors     = 0U;
+  FlagStatus erase;
+  FLASH_EraseInitTypeDef erase_init_struct;
+
+  first_page = (Bank == FLASH_BANK_1) ? 0U : FLASH_BANK_PAGE_NUMBER;
+
+  for (page = first_page; page < (first_page + FLASH_BANK_PAGE_NUMBER); page++)
+  {
+    if ((pPagesList[page / 32U] & (1UL << (page % 32U))) != 0U)
+    {
+      selected++;
+    }
+  }
+
+  erase_init_struct.Banks = Bank;
+
+  if ((selected == FLASH_BANK_PAGE_NUMBER) && (FLASH_DELTA_MODE == 0U)
+      && (OPENBL_FLASH_IsBankWriteProtected(Bank) == RESET))
+  {
+    /* The whole bank is erased in a single operation */
+    erase_init_struct.TypeErase = FLASH_TYPEERASE_MASSERASE;
+
+    if (HAL_FLASHEx_Erase(&erase_init_struct, &page_error) != HAL_OK)
+    {
+      errors++;
+    }
+  }
+  else if (selected != 0U)
+  {
+    erase_init_struct.TypeErase = FLASH_TYPEERASE_PAGES;
+    erase_init_struct.NbPages   = 0U;
+
+    for (page = first_page; page <= (first_page + FLASH_BANK_PAGE_NUMBER); page++)
+    {
+      erase = RESET;
+
+      if ((page < (first_page + FLASH_BANK_PAGE_NUMBER)) && ((pPagesList[page / 32U] & (1UL << (page % 32U))) != 0U))
+      {
+        /* Skip the erase operation if the page is already blank */
+        if (OPENBL_FLASH_IsPageBlank(OPENBL_FLASH_GetPageAddress(page)) == SET)
+        {
+          Flash_SkippedErases++;
+        }
+#if (FLASH_DELTA_MODE == 1U)
+        else if ((Flash_PendingErase[page / 32U] & (1UL << (page % 32U))) == 0U)
+        {
+          /* Defer the erase operation until the new content of the page is known */
+          Flash_PendingErase[page / 32U] |= (1UL << (page % 32U));
+          Flash_PendingPages++;
+        }
+        else
+        {
+          /* The erase operation is already deferred */
+        }
+#else
+        else
+        {
+          erase = SET;
+        }
+#endif /* (FLASH_DELTA_MODE == 1U) */
+      }
+
+      if (erase == SET)
+      {
+        /* Add the page to the current run of pages */
+        if (erase_init_struct.NbPages == 0U)
+        {
+          erase_init_struct.Page = page - first_page;
+        }
+
+        erase_init_struct.NbPages++;
+      }
+      else if (erase_init_struct.NbPages != 0U)
+      {
+        /* Erase the run of pages ended by this page */
+        if (OPENBL_FLASH_ExtendedErase(&erase_init_struct, &page_error) != HAL_OK)
+        {
+          errors++;
+        }
+
+        erase_init_struct.NbPages = 0U;
+      }
+      else
+      {
+        /* No run of pages on going */
+      }
+    }
+  }
+  else
+  {
+    /* No page to erase in this bank */
+  }
+
+  return errors;
+}
+
+/**
+  * @brief  Check whether a bank has an active write protection area.
+  * @param  Bank The bank to be checked, FLASH_BANK_1 or FLASH_BANK_2.
+  * @retval Returns SET if the bank is write protected else returns RESET.
+  */
+static FlagStatus OPENBL_FLASH_IsBankWriteProtected(uint32_t Bank)
+{
+  uint32_t area_a = (Bank == FLASH_BANK_1) ? FLASH->WRP1AR : FLASH->WRP2AR;
+  uint32_t area_b = (Bank == FLASH_BANK_1) ? FLASH->WRP1BR : FLASH->WRP2BR;
+  FlagStatus status = RESET;
+
+  /* An area is active when its start offset is lower or equal to its end offset */
+  if (((area_a & FLASH_WRP1AR_WRP1A_PSTRT) <= ((area_a & FLASH_WRP1AR_WRP1A_PEND) >> FLASH_WRP1AR_WRP1A_PEND_Pos))
+      || ((area_b & FLASH_WRP1BR_WRP1B_PSTRT) <= ((area_b & FLASH_WRP1BR_WRP1B_PEND) >> FLASH_WRP1BR_WRP1B_PEND_Pos)))
+  {
+    status = SET;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Check whether a FLASH page is blank (all bytes at 0xFF).
+  * @note   The page is read word by word, eight words per loop iteration, and the check
+  *         stops at the first programmed word.
+  * @param  Address Start address of the page to be checked.
+  * @retval Returns SET if the page is blank else returns RESET.
+  */
+static FlagStatus OPENBL_FLASH_IsPageBlank(uint32_t Address)
+{
+  const uint32_t *p_word = (const uint32_t *)Address;
+  const uint32_t *p_end  = (const uint32_t *)(Address + FLASH_PAGE_SIZE);
+  FlagStatus status      = SET;
+
+  while ((p_word < p_end) && (status == SET))
+  {
+    if ((p_word[0] & p_word[1] & p_word[2] & p_word[3] & p_word[4] & p_word[5] & p_word[6] & p_word[7])
+        != 0xFFFFFFFFU)
+    {
+      status = RESET;
+    }
+
+    p_word += 8U;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  This function is used to enable write protection of the specified FLASH areas.
+  * @param  ListOfPages Contains the list of pages to be protected.
+  * @param  Length The length of the list of pages to be protected.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Enable or disable of the write protection is done
+  *          - ERROR:   Enable or disable of the write protection is not done
+  */
+static ErrorStatus OPENBL_FLASH_EnableWriteProtection(uint8_t *ListOfPages, uint32_t Length)
+{
+  ErrorStatus status       = SUCCESS;
+  FLASH_OBProgramInitTypeDef flash_ob;
+
+  /* Unlock the FLASH registers & Option Bytes registers access */
+  OPENBL_FLASH_OB_Unlock();
+
+  /* Clear error programming flags */
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+
+  flash_ob.OptionType = OPTIONBYTE_WRP;
+
+  /* Write protection of bank 1 area WRPA 1 area */
+  if (Length >= 2U)
+  {
+    flash_ob.WRPArea        = OB_WRPAREA_BANK1_AREAA;
+    flash_ob.WRPStartOffset = *(ListOfPages);
+    flash_ob.WRPEndOffset   = *(ListOfPages + 1U);
+
+    HAL_FLASHEx_OBProgram(&flash_ob);
+  }
+
+  /* Write protection of bank 1 area WRPA 2 area */
+  if (Length >= 4U)
+  {
+    flash_ob.WRPArea        = OB_WRPAREA_BANK1_AREAB;
+    flash_ob.WRPStartOffset = *(ListOfPages + 2U);
+    flash_ob.WRPEndOffset   = *(ListOfPages + 3U);
+
+    HAL_FLASHEx_OBProgram(&flash_ob);
+  }
+
+  /* Write protection of bank 2 area WRPB 1 area */
+  if (Length >= 6U)
+  {
+    flash_ob.WRPArea        = OB_WRPAREA_BANK2_AREAA;
+    flash_ob.WRPStartOffset = *(ListOfPages + 4U);
+    flash_ob.WRPEndOffset   = *(ListOfPages + 5U);
+
+    HAL_FLASHEx_OBProgram(&flash_ob);
+  }
+
+  /* Write protection of bank 2 area WRPB 2 area */
+  if (Length >= 8U)
+  {
+    flash_ob.WRPArea        = OB_WRPAREA_BANK2_AREAB;
+    flash_ob.WRPStartOffset = *(ListOfPages + 6U);
+    flash_ob.WRPEndOffset   = *(ListOfPages + 7U);
+
+    HAL_FLASHEx_OBProgram(&flash_ob);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  This function is used to disable write protection.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Enable or disable of the write protection is done
+  *          - ERROR:   Enable or disable of the write protection is not done
+  */
+static ErrorStatus OPENBL_FLASH_DisableWriteProtection(void)
+{
+  ErrorStatus status       = SUCCESS;
+  FLASH_OBProgramInitTypeDef flash_ob;
+
+  /* Unlock the FLASH registers & Option Bytes registers access */
+  OPENBL_FLASH_OB_Unlock();
+
+  /* Clear error programming flags */
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+
+  flash_ob.OptionType = OPTIONBYTE_WRP;
+
+  /* Disable write protection of bank 1 area WRPA 1 area */
+  flash_ob.WRPArea        = OB_WRPAREA_BANK1_AREAA;
+  flash_ob.WRPStartOffset = FLASH_PAGE_MAX_NUMBER;
+  flash_ob.WRPEndOffset   = 0x00U;
+
+  HAL_FLASHEx_OBProgram(&flash_ob);
+
+  /* Disable write protection of bank 1 area WRPA 2 area */
+  flash_ob.WRPArea        = OB_WRPAREA_BANK1_AREAB;
+  flash_ob.WRPStartOffset = FLASH_PAGE_MAX_NUMBER;
+  flash_ob.WRPEndOffset   = 0x00U;
+
+  HAL_FLASHEx_OBProgram(&flash_ob);
+
+  /* Disable write protection of bank 2 area WRPB 1 area */
+  flash_ob.WRPArea        = OB_WRPAREA_BANK2_AREAA;
+  flash_ob.WRPStartOffset = FLASH_PAGE_MAX_NUMBER;
+  flash_ob.WRPEndOffset   = 0x00U;
+
+  HAL_FLASHEx_OBProgram(&flash_ob);
+
+  /* Disable write protection of bank 2 area WRPB 2 area */
+  flash_ob.WRPArea        = OB_WRPAREA_BANK2_AREAB;
+  flash_ob.WRPStartOffset = FLASH_PAGE_MAX_NUMBER;
+  flash_ob.WRPEndOffset   = 0x00U;
+
+  HAL_FLASHEx_OBProgram(&flash_ob);
+
+  return status;
+}
+
+/**
+  * @brief  Wait for a FLASH operation to complete.
+  * @param  Timeout maximum flash operation timeout in us.
+  * @retval HAL_Status
+  */
+#if defined (__ICCARM__)
+__ramfunc HAL_StatusTypeDef OPENBL_FLASH_WaitForLastOperation(uint32_t Timeout)
+#else
+__attribute__((section(".ramfunc"))) HAL_StatusTypeDef OPENBL_FLASH_WaitForLastOperation(uint32_t Timeout)
+#endif /* (__ICCARM__) */
+{
+  uint32_t deadline = Common_StartTimeout(Timeout);
+  uint32_t error;
+  __IO uint32_t *reg_sr;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  /* While the FLASH is in busy state, send busy byte to the host */
+  while (__HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY))
+  {
+    /* Check if we need to send a busy byte
+       NOTE: this can be removed if I2C protocol is not used */
+    if (Flash_BusyState == FLASH_BUSY_STATE_ENABLED)
+    {
+      OPENBL_I2C_SendBusyByte();
+    }
+
+    if (Common_IsTimeoutElapsed(deadline) == SET)
+    {
+      status = HAL_TIMEOUT;
+      break;
+    }
+  }
+
+  /* Access to SECSR or NSSR registers depends on operation type */
+  reg_sr = IS_FLASH_SECURE_OPERATION() ? &(FLASH->SECSR) : &(FLASH_NS->NSSR);
 
   /* Check FLASH operation error flags */
   error = ((*reg_sr) & FLASH_FLAG_SR_ERRORS);
@@ -634,6 +1773,8 @@ __attribute__((section(".ramfunc"))) HAL_StatusTypeDef OPENBL_FLASH_WaitForLastO
 
 /**
   * @brief  Perform a mass erase or erase the specified FLASH memory pages.
+  * @note   The pages are numbered from the start of the selected bank and NbPages consecutive
+  *         pages are erased with the bank selected only once.
   * @param[in]  pEraseInit pointer to an FLASH_EraseInitTypeDef structure that
   *         contains the configuration information for the erasing.
   * @param[out]  PageError pointer to variable that contains the configuration
@@ -650,6 +1791,7 @@ __attribute__((section(".ramfunc"))) HAL_StatusTypeDef OPENBL_FLASH_ExtendedEras
 {
   /* The example below is for demonstration purposes */
   HAL_StatusTypeDef status;
+  uint32_t page;
   uint32_t errors = 0U;
   __IO uint32_t *reg;
 #if defined (__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U)
@@ -665,12 +1807,6 @@ __attribute__((section(".ramfunc"))) HAL_StatusTypeDef OPENBL_FLASH_ExtendedEras
   /* Verify that next operation can be proceed */
   status = OPENBL_FLASH_WaitForLastOperation(PROGRAM_TIMEOUT);
 
-#if defined (__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U)
-  /* Disable interrupts to avoid any interruption */
-  primask_bit = __get_PRIMASK();
-  __disable_irq();
-#endif
-
   if (status == HAL_OK)
   {
     FlashProcess.ProcedureOnGoing = pEraseInit->TypeErase;
@@ -700,23 +1836,38 @@ __attribute__((section(".ramfunc"))) HAL_StatusTypeDef OPENBL_FLASH_ExtendedEras
       }
     }
 
-    /* Proceed to erase the page */
-    MODIFY_REG((*reg), (FLASH_NSCR_NSPNB | FLASH_NSCR_NSPER),
-               (((pEraseInit->Page) << FLASH_NSCR_NSPNB_Pos) | FLASH_NSCR_NSPER));
+    /* Erase the pages one after the other, the bank is only selected once */
+    for (page = pEraseInit->Page; page < (pEraseInit->Page + pEraseInit->NbPages); page++)
+    {
+#if defined (__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U)
+      /* Disable interrupts to avoid any interruption */
+      primask_bit = __get_PRIMASK();
+      __disable_irq();
+#endif
+
+      /* Proceed to erase the page */
+      MODIFY_REG((*reg), (FLASH_NSCR_NSPNB | FLASH_NSCR_NSPER),
+                 ((page << FLASH_NSCR_NSPNB_Pos) | FLASH_NSCR_NSPER));
 
-    /* Set the start bit */
-    SET_BIT((*reg), FLASH_NSCR_NSSTRT);
+      /* Set the start bit */
+      SET_BIT((*reg), FLASH_NSCR_NSSTRT);
 
 #if defined (__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U)
-    /* Re-enable the interrupts */
-    __set_PRIMASK(primask_bit);
+      /* Re-enable the interrupts */
+      __set_PRIMASK(primask_bit);
 #endif
 
-		/* Wait for last operation to be completed */
-		if (OPENBL_FLASH_WaitForLastOperation(PROGRAM_TIMEOUT) != HAL_OK)
-		{
-			errors++;
-		}
+      /* Wait for last operation to be completed */
+      if (OPENBL_FLASH_WaitForLastOperation(PROGRAM_TIMEOUT) != HAL_OK)
+      {
+        if (errors == 0U)
+        {
+          *PageError = page;
+        }
+
+        errors++;
+      }
+    }
 
     /* If the erase operation is completed, disable the associated bits */
     CLEAR_BIT((*reg), (FlashProcess.ProcedureOnGoing & ~(FLASH_NON_SECURE_MASK)));
@@ -736,3 +1887,169 @@ __attribute__((section(".ramfunc"))) HAL_StatusTypeDef OPENBL_FLASH_ExtendedEras
 
   return status;
 }
+
+/**
+  * @brief  Program a row of consecutive double-words at a specified FLASH address.
+  * @note   The PG bit is kept set for the whole row, so only the end of each double-word
+  *         programming is waited before the next one is written.
+  * @param  Address specifies the address to be programmed, it must be double-word aligned.
+  * @param  pData pointer to the data to be programmed.
+  * @param  Length number of bytes to be programmed, it must be a multiple of 8.
+  * @retval HAL_Status
+  */
+#if defined (__ICCARM__)
+__ramfunc HAL_StatusTypeDef OPENBL_FLASH_ProgramRow(uint32_t Address, uint8_t *pData, uint32_t Length)
+#else
+__attribute__((section(".ramfunc"))) HAL_StatusTypeDef OPENBL_FLASH_ProgramRow(uint32_t Address, uint8_t *pData,
+                                                                            uint32_t Length)
+#endif /* (__ICCARM__) */
+{
+  HAL_StatusTypeDef status;
+  uint32_t index;
+  __IO uint32_t *reg;
+
+  /* Process Locked */
+  __HAL_LOCK(&FlashProcess);
+
+  /* Reset error code */
+  FlashProcess.ErrorCode = HAL_FLASH_ERROR_NONE;
+
+  /* Clear all FLASH errors flags before starting write operation */
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+
+  /* Verify that next operation can be proceed */
+  status = OPENBL_FLASH_WaitForLastOperation(PROGRAM_TIMEOUT);
+
+  if (status == HAL_OK)
+  {
+    /* Access to SECCR or NSCR registers depends on operation type */
+    reg = IS_FLASH_SECURE_OPERATION() ? &(FLASH->SECCR) : &(FLASH_NS->NSCR);
+
+    /* Set PG bit once for the whole row */
+    SET_BIT((*reg), FLASH_NSCR_NSPG);
+
+    for (index = 0U; ((index < Length) && (status == HAL_OK)); index += FLASH_PROG_STEP_SIZE)
+    {
+      /* Program first word */
+      *(__IO uint32_t *)(Address + index) = *(uint32_t *)((uint32_t)pData + index);
+
+      /* Barrier to ensure programming is performed in 2 steps, in right order
+        (independently of compiler optimization behavior) */
+      __ISB();
+
+      /* Program second word */
+      *(__IO uint32_t *)(Address + index + 4U) = *(uint32_t *)((uint32_t)pData + index + 4U);
+
+      /* Wait for the double-word programming to be completed */
+      status = OPENBL_FLASH_WaitForLastOperation(PROGRAM_TIMEOUT);
+    }
+
+    /* If the program operation is completed, disable the PG bit */
+    CLEAR_BIT((*reg), FLASH_NSCR_NSPG);
+  }
+
+  /* Process Unlocked */
+  __HAL_UNLOCK(&FlashProcess);
+
+  return status;
+}
+
+/**
+  * @brief  Start the programming of a queued job, the FLASH must be unlocked.
+  * @note   Only the first double-word is written, the next ones are written by the FLASH interrupt.
+  * @param  pJob The job to be started.
+  * @retval None.
+  */
+#if defined (__ICCARM__)
+__ramfunc void OPENBL_FLASH_AsyncStartJob(OPENBL_FLASH_JobTypeDef *pJob)
+#else
+__attribute__((section(".ramfunc"))) void OPENBL_FLASH_AsyncStartJob(OPENBL_FLASH_JobTypeDef *pJob)
+#endif /* (__ICCARM__) */
+{
+  __IO uint32_t *reg;
+
+  /* Access to SECCR or NSCR registers depends on operation type */
+  reg = IS_FLASH_SECURE_OPERATION() ? &(FLASH->SECCR) : &(FLASH_NS->NSCR);
+
+  /* Set PG bit and enable the end of operation and error interrupts */
+  SET_BIT((*reg), (FLASH_NSCR_NSPG | FLASH_NSCR_NSEOPIE | FLASH_NSCR_NSERRIE));
+
+  Flash_JobStartCycle = DWT->CYCCNT;
+
+  /* Program first word */
+  *(__IO uint32_t *)(pJob->Address) = pJob->Data[0U];
+
+  /* Barrier to ensure programming is performed in 2 steps, in right order
+    (independently of compiler optimization behavior) */
+  __ISB();
+
+  /* Program second word */
+  *(__IO uint32_t *)(pJob->Address + 4U) = pJob->Data[1U];
+}
+
+/**
+  * @brief  Handle the FLASH interrupt: program the next double-word of the queued jobs.
+  * @retval None.
+  */
+#if defined (__ICCARM__)
+__ramfunc void OPENBL_FLASH_IRQHandler(void)
+#else
+__attribute__((section(".ramfunc"))) void OPENBL_FLASH_IRQHandler(void)
+#endif /* (__ICCARM__) */
+{
+  uint32_t error;
+  __IO uint32_t *reg_sr;
+  __IO uint32_t *reg_cr;
+  OPENBL_FLASH_JobTypeDef *p_job = &Flash_Jobs[Flash_JobsHead];
+
+  /* Access to SECSR/SECCR or NSSR/NSCR registers depends on operation type */
+  reg_sr = IS_FLASH_SECURE_OPERATION() ? &(FLASH->SECSR) : &(FLASH_NS->NSSR);
+  reg_cr = IS_FLASH_SECURE_OPERATION() ? &(FLASH->SECCR) : &(FLASH_NS->NSCR);
+
+  error = ((*reg_sr) & FLASH_FLAG_SR_ERRORS);
+
+  /* Clear FLASH End of Operation pending bit and error flags */
+  (*reg_sr) = (error | FLASH_FLAG_EOP);
+
+  if (Flash_JobsCount != 0U)
+  {
+    if (error != 0U)
+    {
+      /* Save the error code to be reported and abort the job */
+      Flash_ProgramError |= error;
+      p_job->Index = p_job->Length;
+    }
+    else
+    {
+      p_job->Index += FLASH_PROG_STEP_SIZE;
+    }
+
+    if (p_job->Index < p_job->Length)
+    {
+      /* Program next double-word */
+      *(__IO uint32_t *)(p_job->Address + p_job->Index) = p_job->Data[p_job->Index / 4U];
+
+      __ISB();
+
+      *(__IO uint32_t *)(p_job->Address + p_job->Index + 4U) = p_job->Data[(p_job->Index / 4U) + 1U];
+    }
+    else
+    {
+      Flash_BusyCycles += DWT->CYCCNT - Flash_JobStartCycle;
+
+      Flash_JobsHead = (Flash_JobsHead + 1U) % FLASH_ASYNC_JOBS;
+      Flash_JobsCount--;
+
+      if (Flash_JobsCount != 0U)
+      {
+        OPENBL_FLASH_AsyncStartJob(&Flash_Jobs[Flash_JobsHead]);
+      }
+      else
+      {
+        /* Disable PG bit and interrupts and lock the Flash once the queue is empty */
+        CLEAR_BIT((*reg_cr), (FLASH_NSCR_NSPG | FLASH_NSCR_NSEOPIE | FLASH_NSCR_NSERRIE));
+        SET_BIT((*reg_cr), FLASH_NSCR_NSLOCK);
+      }
+    }
+  }
+}
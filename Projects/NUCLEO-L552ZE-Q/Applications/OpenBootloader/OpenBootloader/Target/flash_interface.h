@@ -31,7 +31,9 @@ extern "C" {
 /* Exported constants --------------------------------------------------------*/
 #define FLASH_BUSY_STATE_ENABLED          ((uint32_t)0xAAAA0000)
 #define FLASH_BUSY_STATE_DISABLED         ((uint32_t)0x0000DDDD)
-#define PROGRAM_TIMEOUT                   ((uint32_t)0x00FFFFFF)
+#define PROGRAM_TIMEOUT                   1000000U  /* Maximum FLASH operation time in us */
+#define FLASH_STATS_SIZE                  28U       /* Size of the FLASH statistics in bytes */
+#define FLASH_STATS_RESET                 0x01U     /* Reset the FLASH statistics once read */
 
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
@@ -50,14 +52,20 @@ ErrorStatus OPENBL_FLASH_SetWriteProtection(FunctionalState State, uint8_t *List
 uint32_t OPENBL_FLASH_GetReadOutProtectionLevel(void);
 void OPENBL_Enable_BusyState_Flag(void);
 void OPENBL_Disable_BusyState_Flag(void);
+ErrorStatus OPENBL_FLASH_GetStatistics(uint8_t *pData, uint32_t DataLength, uint8_t *pStats);
+ErrorStatus OPENBL_FLASH_Flush(void);
+void OPENBL_FLASH_Init(void);
+ErrorStatus OPENBL_FLASH_SwapBank(uint8_t *pData, uint32_t DataLength);
 
 #if defined (__ICCARM__)
 __ramfunc HAL_StatusTypeDef OPENBL_FLASH_WaitForLastOperation(uint32_t Timeout);
 __ramfunc HAL_StatusTypeDef OPENBL_FLASH_ExtendedErase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *pPageError);
+__ramfunc void OPENBL_FLASH_IRQHandler(void);
 #else
 __attribute__((section(".ramfunc"))) HAL_StatusTypeDef OPENBL_FLASH_WaitForLastOperation(uint32_t Timeout);
 __attribute__((section(".ramfunc"))) HAL_StatusTypeDef OPENBL_FLASH_ExtendedErase(
   FLASH_EraseInitTypeDef *pEraseInit, uint32_t *pPageError);
+__attribute__((section(".ramfunc"))) void OPENBL_FLASH_IRQHandler(void);
 #endif /* (__ICCARM__) */
 
 #ifdef __cplusplus
@@ -0,0 +1,338 @@
+/**
+  ******************************************************************************
+  * @file    hash_interface.c
+  * @author  MCD Application Team
+  * @brief   Contains SHA-256 digest functions
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "platform.h"
+#include "openbl_mem.h"
+#include "app_openbootloader.h"
+#include "common_interface.h"
+#include "flash_interface.h"
+#include "hash_interface.h"
+#include "iwdg_interface.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define HASH_SHA256_BLOCK_SIZE            64U  /* Size of a SHA-256 block in bytes */
+#define HASH_SHA256_REFRESH_BLOCKS        1024U  /* Number of blocks processed between two IWDG refreshes */
+
+/* Private macro -------------------------------------------------------------*/
+#define HASH_ROTR(x, n)                   (((x) >> (n)) | ((x) << (32U - (n))))
+#define HASH_CH(x, y, z)                  ((z) ^ ((x) & ((y) ^ (z))))
+#define HASH_MAJ(x, y, z)                 (((x) & (y)) | ((z) & ((x) | (y))))
+#define HASH_SUM0(x)                      (HASH_ROTR((x), 2U) ^ HASH_ROTR((x), 13U) ^ HASH_ROTR((x), 22U))
+#define HASH_SUM1(x)                      (HASH_ROTR((x), 6U) ^ HASH_ROTR((x), 11U) ^ HASH_ROTR((x), 25U))
+#define HASH_SIG0(x)                      (HASH_ROTR((x), 7U) ^ HASH_ROTR((x), 18U) ^ ((x) >> 3U))
+#define HASH_SIG1(x)                      (HASH_ROTR((x), 17U) ^ HASH_ROTR((x), 19U) ^ ((x) >> 10U))
+
+/* Next message schedule word, the schedule is kept in a 16 words circular buffer */
+#define HASH_SCHEDULE(w, i)               ((w)[(i) & 15U] += HASH_SIG1((w)[((i) - 2U) & 15U]) \
+                                                             + (w)[((i) - 7U) & 15U]           \
+                                                             + HASH_SIG0((w)[((i) - 15U) & 15U]))
+
+/* One round, the working variables are renamed by the caller instead of being moved */
+#define HASH_ROUND(a, b, c, d, e, f, g, h, k, x)                          \
+  do                                                                      \
+  {                                                                       \
+    temp = (h) + HASH_SUM1(e) + HASH_CH((e), (f), (g)) + (k) + (x);       \
+    (d) += temp;                                                          \
+    (h) = temp + HASH_SUM0(a) + HASH_MAJ((a), (b), (c));                  \
+  } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+/* The round constants are kept in SRAM to avoid the FLASH wait states in the transform */
+static uint32_t Hash_K[64] =
+{
+  0x428A2F98U, 0x71374491U, 0xB5C0FBCFU, 0xE9B5DBA5U, 0x3956C25BU, 0x59F111F1U, 0x923F82A4U, 0xAB1C5ED5U,
+  0xD807AA98U, 0x12835B01U, 0x243185BEU, 0x550C7DC3U, 0x72BE5D74U, 0x80DEB1FEU, 0x9BDC06A7U, 0xC19BF174U,
+  0xE49B69C1U, 0xEFBE4786U, 0x0FC19DC6U, 0x240CA1CCU, 0x2DE92C6FU, 0x4A7484AAU, 0x5CB0A9DCU, 0x76F988DAU,
+  0x983E5152U, 0xA831C66DU, 0xB00327C8U, 0xBF597FC7U, 0xC6E00BF3U, 0xD5A79147U, 0x06CA6351U, 0x14292967U,
+  0x27B70A85U, 0x2E1B2138U, 0x4D2C6DFCU, 0x53380D13U, 0x650A7354U, 0x766A0ABBU, 0x81C2C92EU, 0x92722C85U,
+  0xA2BFE8A1U, 0xA81A664BU, 0xC24B8B70U, 0xC76C51A3U, 0xD192E819U, 0xD6990624U, 0xF40E3585U, 0x106AA070U,
+  0x19A4C116U, 0x1E376C08U, 0x2748774CU, 0x34B0BCB5U, 0x391C0CB3U, 0x4ED8AA4AU, 0x5B9CCA4FU, 0x682E6FF3U,
+  0x748F82EEU, 0x78A5636FU, 0x84C87814U, 0x8CC70208U, 0x90BEFFFAU, 0xA4506CEBU, 0xBEF9A3F7U, 0xC67178F2U
+};
+
+static FlagStatus Hash_ImageCheck = RESET;
+static uint32_t Hash_ImageAddress = 0U;
+static uint32_t Hash_ImageLength = 0U;
+static uint8_t Hash_ImageDigest[HASH_SHA256_DIGEST_SIZE];
+
+/* Private function prototypes -----------------------------------------------*/
+static ErrorStatus OPENBL_HASH_CheckRegion(uint32_t Address, uint32_t Length);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Check that a region is inside one of the registered memories and can be read.
+  * @param  Address The start address of the region.
+  * @param  Length The length of the region in bytes.
+  * @retval Returns SUCCESS if the region can be hashed else returns ERROR.
+  */
+static ErrorStatus OPENBL_HASH_CheckRegion(uint32_t Address, uint32_t Length)
+{
+  ErrorStatus status = ERROR;
+
+  if ((Common_GetProtectionStatus() == RESET) && (Length != 0U) && ((Address + Length - 1U) >= Address)
+      && (OPENBL_MEM_GetAddressArea(Address) != AREA_ERROR)
+      && (OPENBL_MEM_GetAddressArea(Address) == OPENBL_MEM_GetAddressArea(Address + Length - 1U)))
+  {
+    status = SUCCESS;
+  }
+
+  return status;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Compute the SHA-256 digest of a memory area.
+  * @note   The complete blocks are hashed in place, only the last ones are copied for the padding.
+  * @param  Address The start address of the area.
+  * @param  Length The length of the area in bytes.
+  * @param  pDigest Pointer to the 32 bytes digest.
+  * @retval None.
+  */
+void OPENBL_HASH_Sha256(uint32_t Address, uint32_t Length, uint8_t *pDigest)
+{
+  uint32_t index;
+  uint32_t blocks;
+  uint32_t remaining;
+  uint32_t state[8];
+  uint32_t last_blocks[(2U * HASH_SHA256_BLOCK_SIZE) / 4U];
+  uint8_t *p_last = (uint8_t *)last_blocks;
+
+  state[0] = 0x6A09E667U;
+  state[1] = 0xBB67AE85U;
+  state[2] = 0x3C6EF372U;
+  state[3] = 0xA54FF53AU;
+  state[4] = 0x510E527FU;
+  state[5] = 0x9B05688CU;
+  state[6] = 0x1F83D9ABU;
+  state[7] = 0x5BE0CD19U;
+
+  /* Hash the complete blocks directly from the memory */
+  blocks = Length / HASH_SHA256_BLOCK_SIZE;
+
+  while (blocks > 0U)
+  {
+    remaining = (blocks > HASH_SHA256_REFRESH_BLOCKS) ? HASH_SHA256_REFRESH_BLOCKS : blocks;
+
+    OPENBL_HASH_Sha256Transform(state, Address, remaining);
+    OPENBL_IWDG_Refresh();
+
+    Address += remaining * HASH_SHA256_BLOCK_SIZE;
+    blocks  -= remaining;
+  }
+
+  /* Copy the remaining bytes and append the padding and the length in bits */
+  remaining = Length % HASH_SHA256_BLOCK_SIZE;
+  blocks    = (remaining < (HASH_SHA256_BLOCK_SIZE - 8U)) ? 1U : 2U;
+
+  for (index = 0U; index < remaining; index++)
+  {
+    p_last[index] = *(uint8_t *)(Address + index);
+  }
+
+  p_last[remaining] = 0x80U;
+
+  for (index = remaining + 1U; index < ((blocks * HASH_SHA256_BLOCK_SIZE) - 8U); index++)
+  {
+    p_last[index] = 0x00U;
+  }
+
+  last_blocks[(blocks * (HASH_SHA256_BLOCK_SIZE / 4U)) - 2U] = __REV(Length >> 29U);
+  last_blocks[(blocks * (HASH_SHA256_BLOCK_SIZE / 4U)) - 1U] = __REV(Length << 3U);
+
+  OPENBL_HASH_Sha256Transform(state, (uint32_t)last_blocks, blocks);
+
+  /* The digest is the big-endian state */
+  for (index = 0U; index < 8U; index++)
+  {
+    pDigest[4U * index]        = (uint8_t)(state[index] >> 24U);
+    pDigest[(4U * index) + 1U] = (uint8_t)(state[index] >> 16U);
+    pDigest[(4U * index) + 2U] = (uint8_t)(state[index] >> 8U);
+    pDigest[(4U * index) + 3U] = (uint8_t)(state[index]);
+  }
+}
+
+/**
+  * @brief  Compute the SHA-256 digest of a memory region requested by the host.
+  * @note   When the expected digest is given, the region is also checked before jumping to
+  *         the application with the Go command.
+  * @param  pData The region start address and length (4 bytes each, LSB first), optionally
+  *         followed by the expected digest.
+  * @param  DataLength The length of the request, must be 8 or 40.
+  * @param  pDigest Pointer to the computed 32 bytes digest.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: The digest is computed and matches the expected one if given
+  *          - ERROR:   The region is not valid, the data written before could not be programmed or the
+  *                     digest does not match the expected one
+  */
+ErrorStatus OPENBL_HASH_ComputeRegion(uint8_t *pData, uint32_t DataLength, uint8_t *pDigest)
+{
+  uint32_t index;
+  uint32_t address;
+  uint32_t length;
+  ErrorStatus status = ERROR;
+
+  if ((DataLength == 8U) || (DataLength == (8U + HASH_SHA256_DIGEST_SIZE)))
+  {
+    address = (uint32_t)pData[0] | ((uint32_t)pData[1] << 8U) | ((uint32_t)pData[2] << 16U)
+              | ((uint32_t)pData[3] << 24U);
+    length  = (uint32_t)pData[4] | ((uint32_t)pData[5] << 8U) | ((uint32_t)pData[6] << 16U)
+              | ((uint32_t)pData[7] << 24U);
+
+    if (OPENBL_HASH_CheckRegion(address, length) == SUCCESS)
+    {
+      /* Complete the deferred FLASH operations before reading the memory */
+      status = OPENBL_FLASH_Flush();
+
+      OPENBL_HASH_Sha256(address, length, pDigest);
+
+      if (DataLength != 8U)
+      {
+        /* Register the image to be checked before the jump */
+        Hash_ImageCheck   = SET;
+        Hash_ImageAddress = address;
+        Hash_ImageLength  = length;
+
+        for (index = 0U; index < HASH_SHA256_DIGEST_SIZE; index++)
+        {
+          Hash_ImageDigest[index] = pData[8U + index];
+
+          if (pDigest[index] != Hash_ImageDigest[index])
+          {
+            status = ERROR;
+          }
+        }
+      }
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Check the digest of the image registered by the host before jumping to it.
+  * @retval Returns SUCCESS if no image is registered or if its digest matches else returns ERROR.
+  */
+ErrorStatus OPENBL_HASH_CheckImage(void)
+{
+  uint32_t index;
+  uint8_t digest[HASH_SHA256_DIGEST_SIZE];
+  ErrorStatus status = SUCCESS;
+
+  if (Hash_ImageCheck == SET)
+  {
+    OPENBL_HASH_Sha256(Hash_ImageAddress, Hash_ImageLength, digest);
+
+    for (index = 0U; index < HASH_SHA256_DIGEST_SIZE; index++)
+    {
+      if (digest[index] != Hash_ImageDigest[index])
+      {
+        status = ERROR;
+      }
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Process consecutive 64 bytes blocks with the SHA-256 compression function.
+  * @note   This function runs from SRAM, the rounds are unrolled by eight so the working
+  *         variables stay in registers and the message schedule uses a 16 words buffer.
+  * @param  pState Pointer to the 8 words hash state.
+  * @param  Address The address of the first block, it can be unaligned.
+  * @param  Blocks The number of blocks to process.
+  * @retval None.
+  */
+#if defined (__ICCARM__)
+__ramfunc void OPENBL_HASH_Sha256Transform(uint32_t *pState, uint32_t Address, uint32_t Blocks)
+#else
+__attribute__((section(".ramfunc"))) void OPENBL_HASH_Sha256Transform(uint32_t *pState, uint32_t Address,
+                                                                       uint32_t Blocks)
+#endif /* (__ICCARM__) */
+{
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+  uint32_t d;
+  uint32_t e;
+  uint32_t f;
+  uint32_t g;
+  uint32_t h;
+  uint32_t temp;
+  uint32_t index;
+  uint32_t w[16];
+
+  while (Blocks > 0U)
+  {
+    a = pState[0];
+    b = pState[1];
+    c = pState[2];
+    d = pState[3];
+    e = pState[4];
+    f = pState[5];
+    g = pState[6];
+    h = pState[7];
+
+    /* Rounds 0 to 15 use the big-endian words of the block */
+    for (index = 0U; index < 16U; index++)
+    {
+      w[index] = __REV(__UNALIGNED_UINT32_READ((void *)(Address + (4U * index))));
+    }
+
+    for (index = 0U; index < 16U; index += 8U)
+    {
+      HASH_ROUND(a, b, c, d, e, f, g, h, Hash_K[index],      w[index]);
+      HASH_ROUND(h, a, b, c, d, e, f, g, Hash_K[index + 1U], w[index + 1U]);
+      HASH_ROUND(g, h, a, b, c, d, e, f, Hash_K[index + 2U], w[index + 2U]);
+      HASH_ROUND(f, g, h, a, b, c, d, e, Hash_K[index + 3U], w[index + 3U]);
+      HASH_ROUND(e, f, g, h, a, b, c, d, Hash_K[index + 4U], w[index + 4U]);
+      HASH_ROUND(d, e, f, g, h, a, b, c, Hash_K[index + 5U], w[index + 5U]);
+      HASH_ROUND(c, d, e, f, g, h, a, b, Hash_K[index + 6U], w[index + 6U]);
+      HASH_ROUND(b, c, d, e, f, g, h, a, Hash_K[index + 7U], w[index + 7U]);
+    }
+
+    /* Rounds 16 to 63 extend the message schedule on the fly */
+    for (index = 16U; index < 64U; index += 8U)
+    {
+      HASH_ROUND(a, b, c, d, e, f, g, h, Hash_K[index],      HASH_SCHEDULE(w, index));
+      HASH_ROUND(h, a, b, c, d, e, f, g, Hash_K[index + 1U], HASH_SCHEDULE(w, index + 1U));
+      HASH_ROUND(g, h, a, b, c, d, e, f, Hash_K[index + 2U], HASH_SCHEDULE(w, index + 2U));
+      HASH_ROUND(f, g, h, a, b, c, d, e, Hash_K[index + 3U], HASH_SCHEDULE(w, index + 3U));
+      HASH_ROUND(e, f, g, h, a, b, c, d, Hash_K[index + 4U], HASH_SCHEDULE(w, index + 4U));
+      HASH_ROUND(d, e, f, g, h, a, b, c, Hash_K[index + 5U], HASH_SCHEDULE(w, index + 5U));
+      HASH_ROUND(c, d, e, f, g, h, a, b, Hash_K[index + 6U], HASH_SCHEDULE(w, index + 6U));
+      HASH_ROUND(b, c, d, e, f, g, h, a, Hash_K[index + 7U], HASH_SCHEDULE(w, index + 7U));
+    }
+
+    pState[0] += a;
+    pState[1] += b;
+    pState[2] += c;
+    pState[3] += d;
+    pState[4] += e;
+    pState[5] += f;
+    pState[6] += g;
+    pState[7] += h;
+
+    Address += HASH_SHA256_BLOCK_SIZE;
+    Blocks--;
+  }
+}
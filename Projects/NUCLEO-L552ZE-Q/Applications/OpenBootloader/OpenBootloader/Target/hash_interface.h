@@ -0,0 +1,49 @@
+/**
+  ******************************************************************************
+  * @file    hash_interface.h
+  * @author  MCD Application Team
+  * @brief   Header for hash_interface.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef HASH_INTERFACE_H
+#define HASH_INTERFACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+#define HASH_SHA256_DIGEST_SIZE           32U  /* Size of a SHA-256 digest in bytes */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+void OPENBL_HASH_Sha256(uint32_t Address, uint32_t Length, uint8_t *pDigest);
+ErrorStatus OPENBL_HASH_ComputeRegion(uint8_t *pData, uint32_t DataLength, uint8_t *pDigest);
+ErrorStatus OPENBL_HASH_CheckImage(void);
+
+#if defined (__ICCARM__)
+__ramfunc void OPENBL_HASH_Sha256Transform(uint32_t *pState, uint32_t Address, uint32_t Blocks);
+#else
+__attribute__((section(".ramfunc"))) void OPENBL_HASH_Sha256Transform(uint32_t *pState, uint32_t Address,
+                                                                       uint32_t Blocks);
+#endif /* (__ICCARM__) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HASH_INTERFACE_H */
@@ -21,19 +21,60 @@
 #include "interfaces_conf.h"
 #include "openbl_core.h"
 #include "openbl_i2c_cmd.h"
+#include "app_openbootloader.h"
+#include "common_interface.h"
 #include "i2c_interface.h"
 #include "iwdg_interface.h"
 #include "flash_interface.h"
+#include "crc_interface.h"
+#include "decompress_interface.h"
+#include "hash_interface.h"
+#include "patch_interface.h"
 
 /* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t Frequency;     /* Maximum SCL frequency in Hz */
+  uint32_t LowMin;        /* Minimum SCL low period in ns */
+  uint32_t HighMin;       /* Minimum SCL high period in ns */
+  uint32_t DataSetupMin;  /* Minimum data setup time in ns */
+  uint32_t DataValidMax;  /* Maximum data valid time in ns */
+  uint32_t RiseMax;       /* Maximum rise time in ns */
+  uint32_t FallMax;       /* Maximum fall time in ns */
+} I2C_SpeedTypeDef;
+
 /* Private define ------------------------------------------------------------*/
+#define I2C_AF_DELAY_MIN                  50U  /* Minimum analog filter delay in ns */
+#define I2C_AF_DELAY_MAX                  260U  /* Maximum analog filter delay in ns */
+#define I2C_RX_BUFFER_SIZE                512U  /* Size of the DMA receive ring buffer */
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static uint8_t I2cDetected = 0U;
+static uint32_t I2cSpeed = I2C_SPEED;
+static FlagStatus I2cSpeedPending = RESET;
+static uint8_t I2cRxBuffer[I2C_RX_BUFFER_SIZE];
+static uint32_t I2cRxTail = 0U;
+
+/* I2C-bus specification characteristics, indexed by speed mode */
+static const I2C_SpeedTypeDef I2cSpeeds[] =
+{
+  {100000U, 4700U, 4000U, 250U, 3450U, 1000U, 300U},
+  {400000U, 1300U, 600U, 100U, 900U, 300U, 300U},
+  {1000000U, 500U, 260U, 50U, 450U, 120U, 120U}
+};
 
 /* Exported variables --------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 static void OPENBL_I2C_Init(void);
+static uint32_t OPENBL_I2C_ComputeTiming(uint32_t Speed);
+static ErrorStatus OPENBL_I2C_RequestSpeed(uint8_t *pData, uint32_t DataLength);
+static void OPENBL_I2C_ApplySpeed(void);
+static void OPENBL_I2C_StartReception(void);
+static void OPENBL_I2C_StartTransmission(void);
+static uint32_t OPENBL_I2C_GetRxHead(void);
+static uint32_t OPENBL_I2C_WaitRxData(void);
+static void OPENBL_I2C_SendSpecialCmdResponse(uint8_t *pData, uint16_t DataSize, uint8_t Status);
 
 /* Private functions ---------------------------------------------------------*/
 
@@ -46,17 +87,240 @@ static void OPENBL_I2C_Init(void)
   LL_I2C_InitTypeDef I2C_InitStruct;
 
   I2C_InitStruct.PeripheralMode  = LL_I2C_MODE_I2C;
-  I2C_InitStruct.Timing          = I2C_TIMING;
+  I2C_InitStruct.Timing          = OPENBL_I2C_ComputeTiming(I2cSpeed);
   I2C_InitStruct.AnalogFilter    = LL_I2C_ANALOGFILTER_ENABLE;
   I2C_InitStruct.DigitalFilter   = 0U;
   I2C_InitStruct.OwnAddress1     = I2C_ADDRESS;
   I2C_InitStruct.TypeAcknowledge = LL_I2C_NACK;
   I2C_InitStruct.OwnAddrSize     = LL_I2C_OWNADDRESS1_7BIT;
 
+  if (I2cSpeed == I2C_SPEED_FAST_PLUS)
+  {
+    HAL_I2CEx_EnableFastModePlus(I2Cx_FASTMODEPLUS);
+  }
+
   LL_I2C_Init(I2Cx, &I2C_InitStruct);
   LL_I2C_Enable(I2Cx);
 }
 
+/**
+ * @brief  This function is used to compute the I2C timing register value of a speed mode.
+ * @note   The value is computed from the I2C kernel clock and the I2C-bus specification, with
+ *         the analog filter enabled and the digital filter disabled. The smallest prescaler
+ *         fitting the fields is used for the best resolution.
+ * @param  Speed The speed mode, I2C_SPEED_STANDARD, I2C_SPEED_FAST or I2C_SPEED_FAST_PLUS.
+ * @retval Returns the timing register value, 0 if the kernel clock is too slow for the speed mode.
+ */
+static uint32_t OPENBL_I2C_ComputeTiming(uint32_t Speed)
+{
+  const I2C_SpeedTypeDef *speed = &I2cSpeeds[Speed];
+  uint32_t cycle  = 1000000000U / (I2Cx_GetClockFreq() / 1000U);  /* Kernel clock period in ps */
+  uint32_t sync   = (I2C_AF_DELAY_MIN * 1000U) + (3U * cycle);      /* SCL edge detection delay in ps */
+  uint32_t period = 1000000000U / (speed->Frequency / 1000U);       /* SCL period in ps */
+  uint32_t prescaler;
+  uint32_t tick;
+  uint32_t setup;
+  uint32_t hold;
+  uint32_t hold_max;
+  uint32_t low;
+  uint32_t high;
+  uint32_t total;
+  uint32_t timing = 0U;
+
+  for (prescaler = 0U; (prescaler < 16U) && (timing == 0U); prescaler++)
+  {
+    tick = (prescaler + 1U) * cycle;
+
+    /* The data setup time covers the rise time of SDA */
+    setup = ((((speed->RiseMax + speed->DataSetupMin) * 1000U) + tick - 1U) / tick);
+
+    /* The data hold time covers the fall time of SCL, unless it exceeds the data valid time */
+    hold     = ((speed->FallMax * 1000U) > sync) ? (((speed->FallMax * 1000U) - sync + tick - 1U) / tick) : 0U;
+    hold_max = (speed->DataValidMax - speed->RiseMax - I2C_AF_DELAY_MAX) * 1000U;
+    hold_max = (hold_max > (4U * cycle)) ? ((hold_max - (4U * cycle)) / tick) : 0U;
+    hold     = (hold > hold_max) ? hold_max : hold;
+
+    /* The SCL period left after the minimum high period is given to the low period */
+    low   = ((speed->LowMin * 1000U) + tick - 1U) / tick;
+    high  = ((speed->HighMin * 1000U) + tick - 1U) / tick;
+    total = (period - ((speed->RiseMax + speed->FallMax) * 1000U) - (2U * sync)) / tick;
+    low   = (total > (low + high)) ? (total - high) : low;
+
+    if ((setup <= 16U) && (hold <= 15U) && (low <= 256U) && (high <= 256U))
+    {
+      timing = __LL_I2C_CONVERT_TIMINGS(prescaler, setup - 1U, hold, high - 1U, low - 1U);
+    }
+  }
+
+  return timing;
+}
+
+/**
+ * @brief  This function is used to check the speed mode requested by the host.
+ * @note   The speed mode is applied before receiving the next command, the response of the
+ *         request being sent with the current one.
+ * @param  pData The request, the speed mode (1 byte).
+ * @param  DataLength The length of the request, must be 1.
+ * @retval Returns SUCCESS if the speed mode can be used with the I2C kernel clock else returns ERROR.
+ */
+static ErrorStatus OPENBL_I2C_RequestSpeed(uint8_t *pData, uint32_t DataLength)
+{
+  ErrorStatus status = ERROR;
+
+  if ((DataLength == 1U) && (pData[0] <= I2C_SPEED_FAST_PLUS) && (OPENBL_I2C_ComputeTiming(pData[0]) != 0U))
+  {
+    I2cSpeed        = pData[0];
+    I2cSpeedPending = SET;
+    status          = SUCCESS;
+  }
+
+  return status;
+}
+
+/**
+ * @brief  This function is used to switch the I2C to the requested speed mode.
+ * @note   The I2C is disabled while its timing is changed, the Fast-mode Plus drive is only
+ *         enabled on the I2C pins at 1 MHz.
+ * @retval None.
+ */
+static void OPENBL_I2C_ApplySpeed(void)
+{
+  I2cSpeedPending = RESET;
+
+  LL_I2C_Disable(I2Cx);
+
+  LL_I2C_SetTiming(I2Cx, OPENBL_I2C_ComputeTiming(I2cSpeed));
+
+  if (I2cSpeed == I2C_SPEED_FAST_PLUS)
+  {
+    HAL_I2CEx_EnableFastModePlus(I2Cx_FASTMODEPLUS);
+  }
+  else
+  {
+    HAL_I2CEx_DisableFastModePlus(I2Cx_FASTMODEPLUS);
+  }
+
+  LL_I2C_Enable(I2Cx);
+}
+
+/**
+ * @brief  This function is used to start the reception of the I2C data in the DMA ring buffer.
+ * @note   The address phases are still handled by the CPU, the host being held by clock stretching
+ *         until the address match is acknowledged. The data phases are then received at the bus
+ *         speed whatever the CPU is doing.
+ * @retval None.
+ */
+static void OPENBL_I2C_StartReception(void)
+{
+  LL_DMA_InitTypeDef DMA_InitStruct;
+
+  I2Cx_DMA_CLK_ENABLE();
+  I2Cx_DMAMUX_CLK_ENABLE();
+
+  DMA_InitStruct.PeriphOrM2MSrcAddress  = LL_I2C_DMA_GetRegAddr(I2Cx, LL_I2C_DMA_REG_DATA_RECEIVE);
+  DMA_InitStruct.MemoryOrM2MDstAddress  = (uint32_t)I2cRxBuffer;
+  DMA_InitStruct.Direction              = LL_DMA_DIRECTION_PERIPH_TO_MEMORY;
+  DMA_InitStruct.Mode                   = LL_DMA_MODE_CIRCULAR;
+  DMA_InitStruct.PeriphOrM2MSrcIncMode  = LL_DMA_PERIPH_NOINCREMENT;
+  DMA_InitStruct.MemoryOrM2MDstIncMode  = LL_DMA_MEMORY_INCREMENT;
+  DMA_InitStruct.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE;
+  DMA_InitStruct.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE;
+  DMA_InitStruct.NbData                 = I2C_RX_BUFFER_SIZE;
+  DMA_InitStruct.PeriphRequest          = I2Cx_RX_DMA_REQUEST;
+  DMA_InitStruct.Priority               = LL_DMA_PRIORITY_HIGH;
+
+  LL_DMA_Init(I2Cx_DMAx, I2Cx_RX_DMA_CHANNEL, &DMA_InitStruct);
+  LL_DMA_EnableChannel(I2Cx_DMAx, I2Cx_RX_DMA_CHANNEL);
+
+  I2cRxTail = 0U;
+
+  LL_I2C_EnableDMAReq_RX(I2Cx);
+}
+
+/**
+ * @brief  This function is used to configure the DMA channel sending the I2C data blocks.
+ * @retval None.
+ */
+static void OPENBL_I2C_StartTransmission(void)
+{
+  LL_DMA_InitTypeDef DMA_InitStruct;
+
+  DMA_InitStruct.PeriphOrM2MSrcAddress  = LL_I2C_DMA_GetRegAddr(I2Cx, LL_I2C_DMA_REG_DATA_TRANSMIT);
+  DMA_InitStruct.MemoryOrM2MDstAddress  = 0U;
+  DMA_InitStruct.Direction              = LL_DMA_DIRECTION_MEMORY_TO_PERIPH;
+  DMA_InitStruct.Mode                   = LL_DMA_MODE_NORMAL;
+  DMA_InitStruct.PeriphOrM2MSrcIncMode  = LL_DMA_PERIPH_NOINCREMENT;
+  DMA_InitStruct.MemoryOrM2MDstIncMode  = LL_DMA_MEMORY_INCREMENT;
+  DMA_InitStruct.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE;
+  DMA_InitStruct.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE;
+  DMA_InitStruct.NbData                 = 0U;
+  DMA_InitStruct.PeriphRequest          = I2Cx_TX_DMA_REQUEST;
+  DMA_InitStruct.Priority               = LL_DMA_PRIORITY_MEDIUM;
+
+  LL_DMA_Init(I2Cx_DMAx, I2Cx_TX_DMA_CHANNEL, &DMA_InitStruct);
+}
+
+/**
+ * @brief  This function is used to get the position of the next byte written by the DMA in the ring buffer.
+ * @retval Returns the write position.
+ */
+static uint32_t OPENBL_I2C_GetRxHead(void)
+{
+  return (I2C_RX_BUFFER_SIZE - LL_DMA_GetDataLength(I2Cx_DMAx, I2Cx_RX_DMA_CHANNEL)) % I2C_RX_BUFFER_SIZE;
+}
+
+/**
+ * @brief  This function is used to wait for data in the receive ring buffer.
+ * @note   A system reset occurs if the host does not send any data before the timeout.
+ * @retval Returns the number of bytes that can be read contiguously from the ring buffer.
+ */
+static uint32_t OPENBL_I2C_WaitRxData(void)
+{
+  uint32_t deadline = Common_StartTimeout(OPENBL_I2C_TIMEOUT);
+  uint32_t head     = OPENBL_I2C_GetRxHead();
+
+  while (head == I2cRxTail)
+  {
+    OPENBL_IWDG_Refresh();
+
+    if (Common_IsTimeoutElapsed(deadline) == SET)
+    {
+      Common_SystemReset();
+    }
+
+    head = OPENBL_I2C_GetRxHead();
+  }
+
+  return (head > I2cRxTail) ? (head - I2cRxTail) : (I2C_RX_BUFFER_SIZE - I2cRxTail);
+}
+
+/**
+ * @brief  This function is used to send the response of a special command.
+ * @param  pData Pointer to the data to be sent, can be NULL if DataSize is 0.
+ * @param  DataSize Number of data bytes.
+ * @param  Status Status byte sent after the data.
+ * @retval None.
+ */
+static void OPENBL_I2C_SendSpecialCmdResponse(uint8_t *pData, uint16_t DataSize, uint8_t Status)
+{
+  /* Send data size */
+  OPENBL_I2C_SendByte((uint8_t)(DataSize >> 8U));
+  OPENBL_I2C_SendByte((uint8_t)(DataSize & 0xFFU));
+
+  /* Send data */
+  OPENBL_I2C_SendBytes(pData, DataSize);
+
+  /* Wait for address to match */
+  OPENBL_I2C_WaitAddress();
+
+  /* Send status size */
+  OPENBL_I2C_SendByte(0x00U);
+  OPENBL_I2C_SendByte(0x01U);
+
+  /* Send status */
+  OPENBL_I2C_SendByte(Status);
+}
+
 /* Exported functions --------------------------------------------------------*/
 
 /**
@@ -127,6 +391,10 @@ uint8_t OPENBL_I2C_ProtocolDetection(void)
   if ((I2Cx->ISR & I2C_ISR_ADDR) != 0)
   {
     I2cDetected = 1U;
+
+    /* The data phases are received in the DMA ring buffer and the data blocks are sent by DMA */
+    OPENBL_I2C_StartReception();
+    OPENBL_I2C_StartTransmission();
   }
   else
   {
@@ -144,6 +412,12 @@ uint8_t OPENBL_I2C_GetCommandOpcode(void)
 {
   uint8_t command_opc;
 
+  /* Switch to the speed mode requested by the previous command */
+  if (I2cSpeedPending == SET)
+  {
+    OPENBL_I2C_ApplySpeed();
+  }
+
   while (LL_I2C_IsActiveFlag_ADDR(I2Cx) == 0U)
   {
     OPENBL_IWDG_Refresh();
@@ -167,23 +441,47 @@ uint8_t OPENBL_I2C_GetCommandOpcode(void)
 
 /**
   * @brief  This function is used to read one byte from I2C pipe.
+  * @note   The byte is taken from the DMA receive ring buffer.
   * @retval Returns the read byte.
   */
 uint8_t OPENBL_I2C_ReadByte(void)
 {
-  uint32_t timeout = 0U;
+  uint8_t byte;
+
+  (void)OPENBL_I2C_WaitRxData();
+
+  byte      = I2cRxBuffer[I2cRxTail];
+  I2cRxTail = (I2cRxTail + 1U) % I2C_RX_BUFFER_SIZE;
+
+  return byte;
+}
+
+/**
+  * @brief  This function is used to read a block of bytes from I2C pipe.
+  * @note   The bytes are copied from the receive ring buffer as soon as they are available.
+  * @param  pBuffer Pointer to the buffer receiving the bytes.
+  * @param  Length The number of bytes to read.
+  * @retval None.
+  */
+void OPENBL_I2C_ReadBytes(uint8_t *pBuffer, uint32_t Length)
+{
+  uint32_t index;
+  uint32_t count;
 
-  while (LL_I2C_IsActiveFlag_RXNE(I2Cx) == 0U)
+  while (Length > 0U)
   {
-    OPENBL_IWDG_Refresh();
+    count = OPENBL_I2C_WaitRxData();
+    count = (count > Length) ? Length : count;
 
-    if ((timeout++) >= OPENBL_I2C_TIMEOUT)
+    for (index = 0U; index < count; index++)
     {
-      NVIC_SystemReset();
+      pBuffer[index] = I2cRxBuffer[I2cRxTail + index];
     }
-  }
 
-  return LL_I2C_ReceiveData8(I2Cx);
+    I2cRxTail = (I2cRxTail + count) % I2C_RX_BUFFER_SIZE;
+    pBuffer  += count;
+    Length   -= count;
+  }
 }
 
 /**
@@ -193,7 +491,7 @@ uint8_t OPENBL_I2C_ReadByte(void)
   */
 void OPENBL_I2C_SendByte(uint8_t Byte)
 {
-  uint32_t timeout = 0U;
+  uint32_t deadline = Common_StartTimeout(OPENBL_I2C_TIMEOUT);
 
   if (LL_I2C_IsActiveFlag_TXIS(I2Cx) == 0U)
   {
@@ -201,9 +499,9 @@ void OPENBL_I2C_SendByte(uint8_t Byte)
     {
       OPENBL_IWDG_Refresh();
 
-      if ((timeout++) >= OPENBL_I2C_TIMEOUT)
+      if (Common_IsTimeoutElapsed(deadline) == SET)
       {
-        NVIC_SystemReset();
+        Common_SystemReset();
       }
     }
   }
@@ -211,21 +509,57 @@ void OPENBL_I2C_SendByte(uint8_t Byte)
   LL_I2C_TransmitData8(I2Cx, Byte);
 }
 
+/**
+  * @brief  This function is used to send a block of bytes through I2C pipe.
+  * @note   The bytes are written in the transmit data register by DMA as the host reads them,
+  *         the function returns once the DMA has read the whole buffer. A system reset occurs
+  *         if the host stops reading before the timeout.
+  * @param  pBuffer Pointer to the bytes to be sent.
+  * @param  Length The number of bytes to send.
+  * @retval None.
+  */
+void OPENBL_I2C_SendBytes(uint8_t *pBuffer, uint32_t Length)
+{
+  uint32_t deadline = Common_StartTimeout(OPENBL_I2C_TIMEOUT);
+
+  if (Length != 0U)
+  {
+    LL_DMA_SetMemoryAddress(I2Cx_DMAx, I2Cx_TX_DMA_CHANNEL, (uint32_t)pBuffer);
+    LL_DMA_SetDataLength(I2Cx_DMAx, I2Cx_TX_DMA_CHANNEL, Length);
+    LL_DMA_EnableChannel(I2Cx_DMAx, I2Cx_TX_DMA_CHANNEL);
+    LL_I2C_EnableDMAReq_TX(I2Cx);
+
+    while (I2Cx_TX_DMA_IsActiveFlag_TC() == 0U)
+    {
+      OPENBL_IWDG_Refresh();
+
+      if (Common_IsTimeoutElapsed(deadline) == SET)
+      {
+        Common_SystemReset();
+      }
+    }
+
+    LL_I2C_DisableDMAReq_TX(I2Cx);
+    I2Cx_TX_DMA_ClearFlag_GI();
+    LL_DMA_DisableChannel(I2Cx_DMAx, I2Cx_TX_DMA_CHANNEL);
+  }
+}
+
 /**
   * @brief  This function is used to wait until the address is matched.
   * @retval None.
   */
 void OPENBL_I2C_WaitAddress(void)
 {
-  uint32_t timeout = 0U;
+  uint32_t deadline = Common_StartTimeout(OPENBL_I2C_TIMEOUT);
 
   while (LL_I2C_IsActiveFlag_ADDR(I2Cx) == 0U)
   {
     OPENBL_IWDG_Refresh();
 
-    if ((timeout++) >= OPENBL_I2C_TIMEOUT)
+    if (Common_IsTimeoutElapsed(deadline) == SET)
     {
-      NVIC_SystemReset();
+      Common_SystemReset();
     }
   }
 
@@ -242,7 +576,7 @@ __ramfunc void OPENBL_I2C_WaitNack(void)
 __attribute__((section(".ramfunc"))) void OPENBL_I2C_WaitNack(void)
 #endif /* (__ICCARM__) */
 {
-  uint32_t timeout = 0U;
+  uint32_t deadline = Common_StartTimeout(OPENBL_I2C_TIMEOUT);
 
   /* While the i2C NACK is not detected, the IWDG is refreshed,
   if the timeout is reached a system reset occurs */
@@ -251,7 +585,7 @@ __attribute__((section(".ramfunc"))) void OPENBL_I2C_WaitNack(void)
     /* Refresh IWDG: reload counter */
     IWDG->KR = IWDG_KEY_RELOAD;
 
-    if ((timeout++) >= OPENBL_I2C_TIMEOUT)
+    if (Common_IsTimeoutElapsed(deadline) == SET)
     {
       /* System Reset */
       SCB->AIRCR  = ((0x5FAUL << SCB_AIRCR_VECTKEY_Pos) |
@@ -274,7 +608,7 @@ __ramfunc void OPENBL_I2C_WaitStop(void)
 __attribute__((section(".ramfunc"))) void OPENBL_I2C_WaitStop(void)
 #endif /* (__ICCARM__) */
 {
-  uint32_t timeout = 0U;
+  uint32_t deadline = Common_StartTimeout(OPENBL_I2C_TIMEOUT);
 
   /* While the i2C stop is not detected, refresh the IWDG,
   if the timeout is reached a system reset occurs */
@@ -283,7 +617,7 @@ __attribute__((section(".ramfunc"))) void OPENBL_I2C_WaitStop(void)
     /* Refresh IWDG: reload counter */
     IWDG->KR = IWDG_KEY_RELOAD;
 
-    if ((timeout++) >= OPENBL_I2C_TIMEOUT)
+    if (Common_IsTimeoutElapsed(deadline) == SET)
     {
       /* System Reset */
       SCB->AIRCR  = (uint32_t)((0x5FAUL << SCB_AIRCR_VECTKEY_Pos)  |
@@ -326,7 +660,7 @@ __ramfunc void OPENBL_I2C_SendBusyByte(void)
 __attribute__((section(".ramfunc"))) void OPENBL_I2C_SendBusyByte(void)
 #endif /* (__ICCARM__) */
 {
-  uint32_t timeout = 0U;
+  uint32_t deadline = Common_StartTimeout(OPENBL_I2C_TIMEOUT);
 
   /* Wait for the received address to match with the device address */
   if (((I2Cx->ISR & I2C_ISR_ADDR) != 0U))
@@ -340,7 +674,7 @@ __attribute__((section(".ramfunc"))) void OPENBL_I2C_SendBusyByte(void)
     {
       IWDG->KR = IWDG_KEY_RELOAD;
 
-      if ((timeout++) >= OPENBL_I2C_TIMEOUT)
+      if (Common_IsTimeoutElapsed(deadline) == SET)
       {
         /* System Reset */
         SCB->AIRCR  = (uint32_t)((0x5FAUL << SCB_AIRCR_VECTKEY_Pos)  |
@@ -368,8 +702,184 @@ __attribute__((section(".ramfunc"))) void OPENBL_I2C_SendBusyByte(void)
  */
 void OPENBL_I2C_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *SpecialCmd)
 {
+  ErrorStatus status;
+  uint32_t crc = 0U;
+  uint32_t length = 0U;
+  uint8_t data[HASH_SHA256_DIGEST_SIZE];
+
   switch (SpecialCmd->OpCode)
   {
+    /* Swap the FLASH banks */
+    case SPECIAL_CMD_SWAP_BANK:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_FLASH_SwapBank(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_I2C_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_I2C_SendByte(0x00U);
+        OPENBL_I2C_SendByte(0x00U);
+      }
+      break;
+
+    /* Compute the CRC32 of a memory region */
+    case SPECIAL_CMD_CRC32:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_CRC_ComputeRegion(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, &crc);
+
+        data[0] = (uint8_t)(crc & 0xFFU);
+        data[1] = (uint8_t)((crc >> 8U) & 0xFFU);
+        data[2] = (uint8_t)((crc >> 16U) & 0xFFU);
+        data[3] = (uint8_t)((crc >> 24U) & 0xFFU);
+
+        if (status == SUCCESS)
+        {
+          OPENBL_I2C_SendSpecialCmdResponse(data, 4U, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_I2C_SendSpecialCmdResponse(NULL, 0U, NACK_BYTE);
+        }
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_I2C_SendByte(0x00U);
+        OPENBL_I2C_SendByte(0x00U);
+      }
+      break;
+
+    /* Compute the SHA-256 digest of a memory region */
+    case SPECIAL_CMD_SHA256:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_HASH_ComputeRegion(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, data);
+
+        if (status == SUCCESS)
+        {
+          OPENBL_I2C_SendSpecialCmdResponse(data, HASH_SHA256_DIGEST_SIZE, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_I2C_SendSpecialCmdResponse(NULL, 0U, NACK_BYTE);
+        }
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_I2C_SendByte(0x00U);
+        OPENBL_I2C_SendByte(0x00U);
+      }
+      break;
+
+    /* Write a compressed stream decompressed in FLASH */
+    case SPECIAL_CMD_DECOMPRESS:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_DECOMPRESS_Control(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, &length);
+
+        if ((status == SUCCESS) && (SpecialCmd->Buffer1[0] == DECOMPRESS_CMD_END))
+        {
+          /* Send the number of decompressed bytes */
+          data[0] = (uint8_t)(length & 0xFFU);
+          data[1] = (uint8_t)((length >> 8U) & 0xFFU);
+          data[2] = (uint8_t)((length >> 16U) & 0xFFU);
+          data[3] = (uint8_t)((length >> 24U) & 0xFFU);
+
+          OPENBL_I2C_SendSpecialCmdResponse(data, 4U, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_I2C_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+        }
+      }
+      else
+      {
+        status = OPENBL_DECOMPRESS_Feed(SpecialCmd->Buffer2, SpecialCmd->SizeBuffer2);
+
+        /* Send status size and status */
+        OPENBL_I2C_SendByte(0x00U);
+        OPENBL_I2C_SendByte(0x01U);
+        OPENBL_I2C_SendByte((status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+      }
+      break;
+
+    /* Write a new image built from a patch of an image in FLASH */
+    case SPECIAL_CMD_PATCH:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_PATCH_Control(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, &length);
+
+        if ((status == SUCCESS) && (SpecialCmd->Buffer1[0] == PATCH_CMD_END))
+        {
+          /* Send the length of the new image */
+          data[0] = (uint8_t)(length & 0xFFU);
+          data[1] = (uint8_t)((length >> 8U) & 0xFFU);
+          data[2] = (uint8_t)((length >> 16U) & 0xFFU);
+          data[3] = (uint8_t)((length >> 24U) & 0xFFU);
+
+          OPENBL_I2C_SendSpecialCmdResponse(data, 4U, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_I2C_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+        }
+      }
+      else
+      {
+        status = OPENBL_PATCH_Feed(SpecialCmd->Buffer2, SpecialCmd->SizeBuffer2);
+
+        /* Send status size and status */
+        OPENBL_I2C_SendByte(0x00U);
+        OPENBL_I2C_SendByte(0x01U);
+        OPENBL_I2C_SendByte((status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+      }
+      break;
+
+    /* Switch the I2C to another speed mode */
+    case SPECIAL_CMD_I2C_SPEED:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_I2C_RequestSpeed(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        /* The response is sent at the current speed mode */
+        OPENBL_I2C_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_I2C_SendByte(0x00U);
+        OPENBL_I2C_SendByte(0x00U);
+      }
+      break;
+
+    /* Read the FLASH statistics */
+    case SPECIAL_CMD_FLASH_STATS:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_FLASH_GetStatistics(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, data);
+
+        if (status == SUCCESS)
+        {
+          OPENBL_I2C_SendSpecialCmdResponse(data, FLASH_STATS_SIZE, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_I2C_SendSpecialCmdResponse(NULL, 0U, NACK_BYTE);
+        }
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_I2C_SendByte(0x00U);
+        OPENBL_I2C_SendByte(0x00U);
+      }
+      break;
+
     /* Unknown command opcode */
     default:
       if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
@@ -404,6 +914,8 @@ void OPENBL_Enable_BusyState_Sending(void)
 {
   /* Enable Flash busy state sending */
   OPENBL_Enable_BusyState_Flag();
+
+  Common_SetBusy();
 }
 
 /**
@@ -414,4 +926,6 @@ void OPENBL_Disable_BusyState_Sending(void)
 {
   /* Disable Flash busy state sending */
   OPENBL_Disable_BusyState_Flag();
+
+  Common_SetReady();
 }
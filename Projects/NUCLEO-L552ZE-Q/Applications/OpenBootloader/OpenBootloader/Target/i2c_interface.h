@@ -31,6 +31,10 @@ extern "C" {
 
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
+#define I2C_SPEED_STANDARD                0x00U  /* Standard-mode, up to 100 kHz */
+#define I2C_SPEED_FAST                    0x01U  /* Fast-mode, up to 400 kHz */
+#define I2C_SPEED_FAST_PLUS               0x02U  /* Fast-mode Plus, up to 1 MHz */
+
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 void OPENBL_I2C_Configuration(void);
@@ -39,7 +43,9 @@ uint8_t OPENBL_I2C_ProtocolDetection(void);
 
 uint8_t OPENBL_I2C_GetCommandOpcode(void);
 uint8_t OPENBL_I2C_ReadByte(void);
+void OPENBL_I2C_ReadBytes(uint8_t *pBuffer, uint32_t Length);
 void OPENBL_I2C_SendByte(uint8_t Byte);
+void OPENBL_I2C_SendBytes(uint8_t *pBuffer, uint32_t Length);
 void OPENBL_I2C_WaitAddress(void);
 void OPENBL_I2C_SendAcknowledgeByte(uint8_t Byte);
 void OPENBL_I2C_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *Frame);
@@ -28,6 +28,8 @@ extern "C" {
 #include "stm32l5xx_ll_usart.h"
 #include "stm32l5xx_ll_i2c.h"
 #include "stm32l5xx_ll_spi.h"
+#include "stm32l5xx_ll_dma.h"
+#include "stm32l5xx_ll_crc.h"
 
 #define MEMORIES_SUPPORTED                6U
 
@@ -37,13 +39,36 @@ extern "C" {
 #define USARTx_CLK_DISABLE()              __HAL_RCC_USART3_CLK_DISABLE()
 #define USARTx_GPIO_CLK_TX_ENABLE()       __HAL_RCC_GPIOD_CLK_ENABLE()
 #define USARTx_GPIO_CLK_RX_ENABLE()       __HAL_RCC_GPIOD_CLK_ENABLE()
+#define USARTx_GPIO_CLK_CTS_ENABLE()      __HAL_RCC_GPIOD_CLK_ENABLE()
+#define USARTx_GPIO_CLK_RTS_ENABLE()      __HAL_RCC_GPIOD_CLK_ENABLE()
 #define USARTx_DeInit()                   LL_USART_DeInit(USARTx)
+#define USARTx_IRQn                       USART3_IRQn
+#define USARTx_GetClockFreq()             HAL_RCC_GetPCLK1Freq()
 
 #define USARTx_TX_PIN                     GPIO_PIN_8
 #define USARTx_TX_GPIO_PORT               GPIOD
 #define USARTx_RX_PIN                     GPIO_PIN_9
 #define USARTx_RX_GPIO_PORT               GPIOD
+#define USARTx_CTS_PIN                    GPIO_PIN_11
+#define USARTx_CTS_GPIO_PORT              GPIOD
+#define USARTx_RTS_PIN                    GPIO_PIN_12  /* Driven as a GPIO from the receive ring buffer level */
+#define USARTx_RTS_GPIO_PORT              GPIOD
 #define USARTx_ALTERNATE                  GPIO_AF7_USART3
+#define OPENBL_USART_TIMEOUT              1000000U  /* Time in us waited for the host before a system reset */
+
+#define USARTx_DMAx                       DMA1
+#define USARTx_RX_DMA_CHANNEL             LL_DMA_CHANNEL_2
+#define USARTx_RX_DMA_REQUEST             LL_DMAMUX_REQ_USART3_RX
+#define USARTx_RX_DMA_IRQn                DMA1_Channel2_IRQn
+#define USARTx_TX_DMA_CHANNEL             LL_DMA_CHANNEL_3
+#define USARTx_TX_DMA_REQUEST             LL_DMAMUX_REQ_USART3_TX
+#define USARTx_DMA_CLK_ENABLE()           __HAL_RCC_DMA1_CLK_ENABLE()
+#define USARTx_DMAMUX_CLK_ENABLE()        __HAL_RCC_DMAMUX1_CLK_ENABLE()
+#define USARTx_RX_DMA_ClearFlag_GI()      LL_DMA_ClearFlag_GI2(USARTx_DMAx)
+#define USARTx_TX_DMA_IsActiveFlag_TC()   LL_DMA_IsActiveFlag_TC3(USARTx_DMAx)
+#define USARTx_TX_DMA_ClearFlag_GI()      LL_DMA_ClearFlag_GI3(USARTx_DMAx)
+#define USARTx_RX_DMA_DeInit()            LL_DMA_DeInit(USARTx_DMAx, USARTx_RX_DMA_CHANNEL)
+#define USARTx_TX_DMA_DeInit()            LL_DMA_DeInit(USARTx_DMAx, USARTx_TX_DMA_CHANNEL)
 
 /* ------------------------- Definitions for I2C -------------------------- */
 #define I2Cx                              I2C3
@@ -59,8 +84,22 @@ extern "C" {
 #define I2Cx_SDA_PIN_PORT                 GPIOC
 #define I2Cx_ALTERNATE                    GPIO_AF4_I2C3
 #define I2C_ADDRESS                       (0x00000058U << 0x01U)
-#define OPENBL_I2C_TIMEOUT                0xFFFFF000U
-#define I2C_TIMING                        0x00800000U
+#define OPENBL_I2C_TIMEOUT                1000000U  /* Time in us waited for the host before a system reset */
+#define I2C_SPEED                         I2C_SPEED_FAST  /* Speed mode used until changed by the host */
+#define I2Cx_GetClockFreq()               HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_I2C3)
+#define I2Cx_FASTMODEPLUS                 I2C_FASTMODEPLUS_I2C3
+
+#define I2Cx_DMAx                         DMA1
+#define I2Cx_RX_DMA_CHANNEL               LL_DMA_CHANNEL_6
+#define I2Cx_RX_DMA_REQUEST               LL_DMAMUX_REQ_I2C3_RX
+#define I2Cx_TX_DMA_CHANNEL               LL_DMA_CHANNEL_7
+#define I2Cx_TX_DMA_REQUEST               LL_DMAMUX_REQ_I2C3_TX
+#define I2Cx_DMA_CLK_ENABLE()             __HAL_RCC_DMA1_CLK_ENABLE()
+#define I2Cx_DMAMUX_CLK_ENABLE()          __HAL_RCC_DMAMUX1_CLK_ENABLE()
+#define I2Cx_TX_DMA_IsActiveFlag_TC()     LL_DMA_IsActiveFlag_TC7(I2Cx_DMAx)
+#define I2Cx_TX_DMA_ClearFlag_GI()        LL_DMA_ClearFlag_GI7(I2Cx_DMAx)
+#define I2Cx_RX_DMA_DeInit()              LL_DMA_DeInit(I2Cx_DMAx, I2Cx_RX_DMA_CHANNEL)
+#define I2Cx_TX_DMA_DeInit()              LL_DMA_DeInit(I2Cx_DMAx, I2Cx_TX_DMA_CHANNEL)
 
 /* -------------------------- Definitions for SPI --------------------------- */
 #define SPIx                              SPI1
@@ -71,7 +110,6 @@ extern "C" {
 #define SPIx_GPIO_CLK_MOSI_ENABLE()       __HAL_RCC_GPIOA_CLK_ENABLE()
 #define SPIx_GPIO_CLK_NSS_ENABLE()        __HAL_RCC_GPIOA_CLK_ENABLE()
 #define SPIx_DeInit()                     LL_SPI_DeInit(SPIx)
-#define SPIx_IRQn                         SPI1_IRQn
 
 #define SPIx_MOSI_PIN                     GPIO_PIN_7
 #define SPIx_MOSI_PIN_PORT                GPIOA
@@ -82,11 +120,31 @@ extern "C" {
 #define SPIx_NSS_PIN                      GPIO_PIN_4
 #define SPIx_NSS_PIN_PORT                 GPIOA
 #define SPIx_ALTERNATE                    GPIO_AF5_SPI1
+#define OPENBL_SPI_TIMEOUT                1000000U  /* Time in us waited for the host before a system reset */
+
+#define SPIx_DMAx                         DMA1
+#define SPIx_RX_DMA_CHANNEL               LL_DMA_CHANNEL_4
+#define SPIx_RX_DMA_REQUEST               LL_DMAMUX_REQ_SPI1_RX
+#define SPIx_TX_DMA_CHANNEL               LL_DMA_CHANNEL_5
+#define SPIx_TX_DMA_REQUEST               LL_DMAMUX_REQ_SPI1_TX
+#define SPIx_DMA_CLK_ENABLE()             __HAL_RCC_DMA1_CLK_ENABLE()
+#define SPIx_DMAMUX_CLK_ENABLE()          __HAL_RCC_DMAMUX1_CLK_ENABLE()
+#define SPIx_TX_DMA_IsActiveFlag_TC()     LL_DMA_IsActiveFlag_TC5(SPIx_DMAx)
+#define SPIx_TX_DMA_ClearFlag_GI()        LL_DMA_ClearFlag_GI5(SPIx_DMAx)
+#define SPIx_RX_DMA_DeInit()              LL_DMA_DeInit(SPIx_DMAx, SPIx_RX_DMA_CHANNEL)
+#define SPIx_TX_DMA_DeInit()              LL_DMA_DeInit(SPIx_DMAx, SPIx_TX_DMA_CHANNEL)
+
+/* ---------------------- Definitions for ready/busy ---------------------- */
+#define READY_BUSY_LINE                   DISABLE  /* Drive a ready/busy line for the SPI and I2C hosts */
+#define READY_BUSY_GPIO_CLK_ENABLE()      __HAL_RCC_GPIOF_CLK_ENABLE()
+#define READY_BUSY_PIN                    GPIO_PIN_12  /* High when the device is ready for the next command */
+#define READY_BUSY_GPIO_PORT              GPIOF
 
 /* ------------------------- Definitions for FDCAN -------------------------- */
 #define FDCANx                            FDCAN1
 #define FDCANx_CLK_ENABLE()               __HAL_RCC_FDCAN1_CLK_ENABLE()
 #define FDCANx_CLK_DISABLE()              __HAL_RCC_FDCAN1_CLK_DISABLE()
+#define FDCANx_IT0_IRQn                   FDCAN1_IT0_IRQn
 #define FDCANx_GPIO_CLK_TX_ENABLE()       __HAL_RCC_GPIOD_CLK_ENABLE()
 #define FDCANx_GPIO_CLK_RX_ENABLE()       __HAL_RCC_GPIOD_CLK_ENABLE()
 
@@ -96,8 +154,22 @@ extern "C" {
 #define FDCANx_RX_PIN                     GPIO_PIN_0
 #define FDCANx_RX_GPIO_PORT               GPIOD
 #define FDCANx_RX_AF                      GPIO_AF9_FDCAN1
+#define OPENBL_FDCAN_TIMEOUT              1000000U  /* Time in us waited for the host before a system reset */
+#define FDCAN_NOMINAL_BITRATE             500000U  /* Arbitration phase bit rate in bit/s */
+#define FDCAN_DATA_BITRATE                FDCAN_DATA_BITRATE_2M  /* Data bit rate used until changed by the host */
+#define FDCANx_GetClockFreq()             HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_FDCAN)
 
 #define FDCANx_FORCE_RESET()              __HAL_RCC_FDCAN1_CLK_DISABLE()
 #define FDCANx_RELEASE_RESET()            __HAL_RCC_FDCAN1_CLK_DISABLE()
 
+/* -------------------------- Definitions for CRC --------------------------- */
+#define CRCx_CLK_ENABLE()                 __HAL_RCC_CRC_CLK_ENABLE()
+#define CRC_DMAx                          DMA1
+#define CRC_DMA_CHANNEL                   LL_DMA_CHANNEL_1
+#define CRC_DMA_CLK_ENABLE()              __HAL_RCC_DMA1_CLK_ENABLE()
+#define CRC_DMAMUX_CLK_ENABLE()           __HAL_RCC_DMAMUX1_CLK_ENABLE()
+#define CRC_DMA_IsActiveFlag_TC()         LL_DMA_IsActiveFlag_TC1(CRC_DMAx)
+#define CRC_DMA_IsActiveFlag_TE()         LL_DMA_IsActiveFlag_TE1(CRC_DMAx)
+#define CRC_DMA_ClearFlag_GI()            LL_DMA_ClearFlag_GI1(CRC_DMAx)
+
 #endif /* INTERFACES_CONF_H */
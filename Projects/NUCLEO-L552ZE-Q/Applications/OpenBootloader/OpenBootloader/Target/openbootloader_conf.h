@@ -63,6 +63,12 @@ extern "C" {
 
 #define OPENBL_DEFAULT_MEM                FLASH_START_ADDRESS  /* Address used for the Erase, Writep and readp command */
 
+#define FLASH_DELTA_MODE                  0U  /* 1U to only erase and program the FLASH pages whose content changes */
+#define FLASH_ASYNC_MODE                  ENABLE  /* Program the FLASH under interrupt while receiving next packet */
+
+#define DECOMPRESS_WINDOW_BITS            10U  /* Compressed write window, 2^10 bytes of SRAM */
+#define DECOMPRESS_LOOKAHEAD_BITS         4U  /* Compressed write back-reference length field size */
+
 #define RDP_LEVEL_0                       OB_RDP_LEVEL_0
 #define RDP_LEVEL_1                       OB_RDP_LEVEL_1
 #define RDP_LEVEL_2                       OB_RDP_LEVEL_2
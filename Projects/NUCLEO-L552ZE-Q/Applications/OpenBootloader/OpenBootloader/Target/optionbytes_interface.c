@@ -21,6 +21,7 @@
 #include "openbl_mem.h"
 #include "app_openbootloader.h"
 #include "common_interface.h"
+#include "flash_interface.h"
 #include "optionbytes_interface.h"
 
 /* Private typedef -----------------------------------------------------------*/
@@ -79,6 +80,9 @@ uint8_t OPENBL_OB_Read(uint32_t Address)
   */
 void OPENBL_OB_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
 {
+  /* Complete the queued FLASH operations */
+  (void)OPENBL_FLASH_Flush();
+
   /* Unlock the FLASH & Option Bytes Registers access */
   HAL_FLASH_Unlock();
   HAL_FLASH_OB_Unlock();
@@ -21,6 +21,7 @@
 #include "openbl_mem.h"
 #include "app_openbootloader.h"
 #include "common_interface.h"
+#include "flash_interface.h"
 #include "otp_interface.h"
 
 /* Private typedef -----------------------------------------------------------*/
@@ -75,6 +76,9 @@ void OPENBL_OTP_Write(uint32_t Address, uint8_t *pData, uint32_t DataLength)
 
   if ((pData != NULL) && (DataLength != 0U))
   {
+    /* Complete the queued FLASH operations */
+    (void)OPENBL_FLASH_Flush();
+
     /* Unlock the flash memory for write operation */
     HAL_FLASH_Unlock();
 
@@ -0,0 +1,287 @@
+/**
+  ******************************************************************************
+  * @file    patch_interface.c
+  * @author  MCD Application Team
+  * @brief   Contains binary patch functions
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "platform.h"
+#include "openbl_mem.h"
+#include "app_openbootloader.h"
+#include "common_interface.h"
+#include "flash_interface.h"
+#include "patch_interface.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+  PATCH_STATE_IDLE = 0U,  /* No patch started */
+  PATCH_STATE_CONTROL,    /* Reading the control record of the next block */
+  PATCH_STATE_DIFF,       /* Reading the bytes added to the old image */
+  PATCH_STATE_EXTRA,      /* Reading the bytes copied to the new image */
+  PATCH_STATE_ERROR       /* The patch does not match the old image or the new image does not fit */
+} PATCH_StateTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define PATCH_CONTROL_SIZE                12U  /* Diff length, extra length and old image seek */
+#define PATCH_OUTPUT_SIZE                 256U  /* New image bytes written to the FLASH at once */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static PATCH_StateTypeDef Patch_State = PATCH_STATE_IDLE;
+static uint32_t Patch_OldAddress = 0U;
+static uint32_t Patch_OldLength = 0U;
+static uint32_t Patch_OldPosition = 0U;
+static uint32_t Patch_NewAddress = 0U;
+static uint32_t Patch_NewLength = 0U;
+static uint32_t Patch_Remaining = 0U;
+static uint32_t Patch_ExtraLength = 0U;
+static uint32_t Patch_Seek = 0U;
+static uint32_t Patch_ControlCount = 0U;
+static uint8_t Patch_Control[PATCH_CONTROL_SIZE];
+static uint32_t Patch_OutputCount = 0U;
+static uint32_t Patch_Output[PATCH_OUTPUT_SIZE / 4U];
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t OPENBL_PATCH_GetWord(uint8_t *pData);
+static void OPENBL_PATCH_NextBlock(void);
+static void OPENBL_PATCH_PutByte(uint8_t Byte);
+static void OPENBL_PATCH_WriteOutput(void);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Get a 32-bit word stored LSB first.
+  * @param  pData Pointer to the 4 bytes of the word.
+  * @retval Returns the word.
+  */
+static uint32_t OPENBL_PATCH_GetWord(uint8_t *pData)
+{
+  return ((uint32_t)pData[0] | ((uint32_t)pData[1] << 8U) | ((uint32_t)pData[2] << 16U)
+          | ((uint32_t)pData[3] << 24U));
+}
+
+/**
+  * @brief  Move to the next non empty part of the patch once the current one is complete.
+  * @retval None.
+  */
+static void OPENBL_PATCH_NextBlock(void)
+{
+  if ((Patch_State == PATCH_STATE_DIFF) && (Patch_Remaining == 0U))
+  {
+    Patch_State     = PATCH_STATE_EXTRA;
+    Patch_Remaining = Patch_ExtraLength;
+  }
+
+  if ((Patch_State == PATCH_STATE_EXTRA) && (Patch_Remaining == 0U))
+  {
+    /* The seek is a signed offset, the old image bounds are checked when it is read */
+    Patch_OldPosition += Patch_Seek;
+
+    Patch_State        = PATCH_STATE_CONTROL;
+    Patch_ControlCount = 0U;
+  }
+}
+
+/**
+  * @brief  Add one byte of the new image to the output buffer.
+  * @param  Byte The new image byte.
+  * @retval None.
+  */
+static void OPENBL_PATCH_PutByte(uint8_t Byte)
+{
+  ((uint8_t *)Patch_Output)[Patch_OutputCount] = Byte;
+  Patch_OutputCount++;
+
+  if (Patch_OutputCount == PATCH_OUTPUT_SIZE)
+  {
+    OPENBL_PATCH_WriteOutput();
+  }
+}
+
+/**
+  * @brief  Write the new image bytes of the output buffer in FLASH memory.
+  * @note   The patch is stopped when the new image exceeds the FLASH memory or would overwrite
+  *         the old image that is still being read.
+  * @retval None.
+  */
+static void OPENBL_PATCH_WriteOutput(void)
+{
+  uint32_t address = Patch_NewAddress + Patch_NewLength;
+
+  if (Patch_OutputCount != 0U)
+  {
+    if ((Patch_OutputCount > (FLASH_END_ADDRESS - address))
+        || (((address + Patch_OutputCount) > Patch_OldAddress) && (address < (Patch_OldAddress + Patch_OldLength))))
+    {
+      Patch_State = PATCH_STATE_ERROR;
+    }
+    else
+    {
+      OPENBL_FLASH_Write(address, (uint8_t *)Patch_Output, Patch_OutputCount);
+
+      Patch_NewLength += Patch_OutputCount;
+    }
+
+    Patch_OutputCount = 0U;
+  }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Start or end the application of a patch requested by the host.
+  * @param  pData The request, PATCH_CMD_START followed by the old image address and length and by
+  *         the new image address (4 bytes each, LSB first) or PATCH_CMD_END.
+  * @param  DataLength The length of the request, must be 13 for a start and 1 for an end.
+  * @param  pLength Pointer to the length of the new image, set when the patch is ended.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: The patch is started or the complete new image is written
+  *          - ERROR:   The request is not valid or the patch cannot be applied or programmed
+  */
+ErrorStatus OPENBL_PATCH_Control(uint8_t *pData, uint32_t DataLength, uint32_t *pLength)
+{
+  uint32_t old_address;
+  uint32_t old_length;
+  uint32_t new_address;
+  ErrorStatus status = ERROR;
+
+  if ((DataLength == 13U) && (pData[0] == PATCH_CMD_START))
+  {
+    old_address = OPENBL_PATCH_GetWord(&pData[1]);
+    old_length  = OPENBL_PATCH_GetWord(&pData[5]);
+    new_address = OPENBL_PATCH_GetWord(&pData[9]);
+
+    if ((Common_GetProtectionStatus() == RESET)
+        && (OPENBL_MEM_GetAddressArea(old_address) == FLASH_AREA)
+        && (old_length <= (FLASH_END_ADDRESS - old_address))
+        && (OPENBL_MEM_GetAddressArea(new_address) == FLASH_AREA))
+    {
+      Patch_State        = PATCH_STATE_CONTROL;
+      Patch_OldAddress   = old_address;
+      Patch_OldLength    = old_length;
+      Patch_OldPosition  = 0U;
+      Patch_NewAddress   = new_address;
+      Patch_NewLength    = 0U;
+      Patch_ControlCount = 0U;
+      Patch_OutputCount  = 0U;
+
+      /* Program the pending data of the old image before reading it */
+      status = OPENBL_FLASH_Flush();
+    }
+  }
+  else if ((DataLength == 1U) && (pData[0] == PATCH_CMD_END) && (Patch_State != PATCH_STATE_IDLE))
+  {
+    OPENBL_PATCH_WriteOutput();
+
+    /* The patch must end on a block boundary */
+    if ((Patch_State == PATCH_STATE_CONTROL) && (Patch_ControlCount == 0U))
+    {
+      status = SUCCESS;
+    }
+
+    /* Program the staged FLASH data so that the image can be checked */
+    if (OPENBL_FLASH_Flush() != SUCCESS)
+    {
+      status = ERROR;
+    }
+
+    *pLength    = Patch_NewLength;
+    Patch_State = PATCH_STATE_IDLE;
+  }
+  else
+  {
+    /* Nothing to do */
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Apply a chunk of the patch stream and write the resulting new image bytes in FLASH memory.
+  * @note   The patch has the bsdiff layout without compression, a sequence of blocks made of a
+  *         control record followed by the diff and the extra bytes:
+  *           - the control record is the diff length, the extra length and the signed seek applied
+  *             to the old image position once the block is done (4 bytes each, LSB first),
+  *           - each diff byte is added to the next old image byte to give a new image byte,
+  *           - the extra bytes are copied to the new image.
+  *         The old image is read in place and a block can be split between two chunks.
+  * @param  pData Pointer to the patch data.
+  * @param  DataLength The length of the patch data.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: The chunk is applied
+  *          - ERROR:   No patch is started or the patch cannot be applied
+  */
+ErrorStatus OPENBL_PATCH_Feed(uint8_t *pData, uint32_t DataLength)
+{
+  uint32_t index;
+  ErrorStatus status = SUCCESS;
+
+  for (index = 0U; (index < DataLength) && (Patch_State != PATCH_STATE_IDLE)
+       && (Patch_State != PATCH_STATE_ERROR); index++)
+  {
+    switch (Patch_State)
+    {
+      case PATCH_STATE_CONTROL:
+        Patch_Control[Patch_ControlCount] = pData[index];
+        Patch_ControlCount++;
+
+        if (Patch_ControlCount == PATCH_CONTROL_SIZE)
+        {
+          Patch_State       = PATCH_STATE_DIFF;
+          Patch_Remaining   = OPENBL_PATCH_GetWord(&Patch_Control[0]);
+          Patch_ExtraLength = OPENBL_PATCH_GetWord(&Patch_Control[4]);
+          Patch_Seek        = OPENBL_PATCH_GetWord(&Patch_Control[8]);
+
+          OPENBL_PATCH_NextBlock();
+        }
+        break;
+
+      case PATCH_STATE_DIFF:
+        if (Patch_OldPosition >= Patch_OldLength)
+        {
+          Patch_State = PATCH_STATE_ERROR;
+        }
+        else
+        {
+          Patch_Remaining--;
+
+          OPENBL_PATCH_PutByte(pData[index] + *(uint8_t *)(Patch_OldAddress + Patch_OldPosition));
+          Patch_OldPosition++;
+
+          OPENBL_PATCH_NextBlock();
+        }
+        break;
+
+      case PATCH_STATE_EXTRA:
+        Patch_Remaining--;
+
+        OPENBL_PATCH_PutByte(pData[index]);
+
+        OPENBL_PATCH_NextBlock();
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  if ((Patch_State == PATCH_STATE_IDLE) || (Patch_State == PATCH_STATE_ERROR))
+  {
+    status = ERROR;
+  }
+
+  return status;
+}
@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file    patch_interface.h
+  * @author  MCD Application Team
+  * @brief   Header for patch_interface.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PATCH_INTERFACE_H
+#define PATCH_INTERFACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+#define PATCH_CMD_START                   0x00U  /* Start applying a patch to an image in FLASH */
+#define PATCH_CMD_END                     0x01U  /* End the patch and get the length of the new image */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+ErrorStatus OPENBL_PATCH_Control(uint8_t *pData, uint32_t DataLength, uint32_t *pLength);
+ErrorStatus OPENBL_PATCH_Feed(uint8_t *pData, uint32_t DataLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PATCH_INTERFACE_H */
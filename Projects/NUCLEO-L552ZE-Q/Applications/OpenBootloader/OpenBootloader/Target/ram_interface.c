@@ -22,6 +22,7 @@
 #include "app_openbootloader.h"
 #include "common_interface.h"
 #include "openbl_core.h"
+#include "flash_interface.h"
 #include "ram_interface.h"
 
 /* Private typedef -----------------------------------------------------------*/
@@ -89,6 +90,9 @@ void OPENBL_RAM_JumpToAddress(uint32_t Address)
 {
   Function_Pointer jump_to_address;
 
+  /* Complete the deferred FLASH operations before leaving the Open Bootloader */
+  (void)OPENBL_FLASH_Flush();
+
   /* De-initialize all HW resources used by the Open Bootloader to their reset values */
   OPENBL_DeInit();
 
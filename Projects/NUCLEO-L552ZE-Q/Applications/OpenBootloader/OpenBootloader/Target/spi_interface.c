@@ -21,7 +21,14 @@
 #include "interfaces_conf.h"
 #include "openbl_core.h"
 #include "openbl_spi_cmd.h"
+#include "app_openbootloader.h"
+#include "common_interface.h"
 #include "spi_interface.h"
+#include "flash_interface.h"
+#include "crc_interface.h"
+#include "decompress_interface.h"
+#include "hash_interface.h"
+#include "patch_interface.h"
 #include "iwdg_interface.h"
 
 /* Private typedef -----------------------------------------------------------*/
@@ -29,21 +36,24 @@
 #define SPI_DUMMY_BYTE                    0x00U  /* Dummy byte */
 #define SPI_SYNC_BYTE                     0x5AU  /* Synchronization byte */
 #define SPI_BUSY_BYTE                     0xA5U  /* Busy byte */
+#define SPI_RX_BUFFER_SIZE                1024U  /* Size of the DMA receive ring buffer */
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
-static volatile uint8_t SpiRxNotEmpty = 0U;
-static uint8_t BusyState;
+static uint8_t BusyState = 0U;
 static uint8_t SpiDetected = 0U;
+static uint8_t SpiRxBuffer[SPI_RX_BUFFER_SIZE];
+static uint32_t SpiRxTail = 0U;
+static uint8_t SpiBusyByte = SPI_BUSY_BYTE;  /* Kept in SRAM so that the DMA reads it during FLASH operations */
 
 /* Exported variables --------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 static void OPENBL_SPI_Init(void);
-#if defined (__ICCARM__)
-__ramfunc void OPENBL_SPI_ClearFlag_OVR(void);
-#else
-__attribute__((section(".ramfunc"))) void OPENBL_SPI_ClearFlag_OVR(void);
-#endif /* (__ICCARM__) */
+static void OPENBL_SPI_StartReception(void);
+static void OPENBL_SPI_StartTransmission(void);
+static void OPENBL_SPI_SendSpecialCmdResponse(uint8_t *pData, uint16_t DataSize, uint8_t Status);
+static uint32_t OPENBL_SPI_GetRxHead(void);
+static uint32_t OPENBL_SPI_WaitRxData(uint32_t Timeout);
 
 /* Private functions ---------------------------------------------------------*/
 
@@ -67,14 +77,129 @@ static void OPENBL_SPI_Init(void)
   SPI_InitStruct.CRCPoly           = 7U;
 
   LL_SPI_Init(SPIx, &SPI_InitStruct);
-  LL_SPI_SetRxFIFOThreshold(SPIx, LL_SPI_RX_FIFO_TH_QUARTER);
 
-  HAL_NVIC_SetPriority(SPIx_IRQn, 0U, 0U);
-  HAL_NVIC_EnableIRQ(SPIx_IRQn);
+  /* Each received byte is moved by the DMA as the length of the host transfers is not known,
+     a byte left alone in a packed FIFO level would never be read */
+  LL_SPI_SetRxFIFOThreshold(SPIx, LL_SPI_RX_FIFO_TH_QUARTER);
 
   LL_SPI_Enable(SPIx);
 }
 
+/**
+ * @brief  This function is used to start the reception of the SPI data in the DMA ring buffer.
+ * @note   The host clocks the bytes in at the SPI rate without any interrupt, the reader polls
+ *         the DMA position.
+ * @retval None.
+ */
+static void OPENBL_SPI_StartReception(void)
+{
+  LL_DMA_InitTypeDef DMA_InitStruct;
+
+  SPIx_DMA_CLK_ENABLE();
+  SPIx_DMAMUX_CLK_ENABLE();
+
+  DMA_InitStruct.PeriphOrM2MSrcAddress  = LL_SPI_DMA_GetRegAddr(SPIx);
+  DMA_InitStruct.MemoryOrM2MDstAddress  = (uint32_t)SpiRxBuffer;
+  DMA_InitStruct.Direction              = LL_DMA_DIRECTION_PERIPH_TO_MEMORY;
+  DMA_InitStruct.Mode                   = LL_DMA_MODE_CIRCULAR;
+  DMA_InitStruct.PeriphOrM2MSrcIncMode  = LL_DMA_PERIPH_NOINCREMENT;
+  DMA_InitStruct.MemoryOrM2MDstIncMode  = LL_DMA_MEMORY_INCREMENT;
+  DMA_InitStruct.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE;
+  DMA_InitStruct.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE;
+  DMA_InitStruct.NbData                 = SPI_RX_BUFFER_SIZE;
+  DMA_InitStruct.PeriphRequest          = SPIx_RX_DMA_REQUEST;
+  DMA_InitStruct.Priority               = LL_DMA_PRIORITY_VERYHIGH;
+
+  LL_DMA_Init(SPIx_DMAx, SPIx_RX_DMA_CHANNEL, &DMA_InitStruct);
+  LL_DMA_EnableChannel(SPIx_DMAx, SPIx_RX_DMA_CHANNEL);
+
+  SpiRxTail = 0U;
+
+  LL_SPI_EnableDMAReq_RX(SPIx);
+}
+
+/**
+ * @brief  This function is used to configure the DMA channel sending the SPI data blocks and the busy bytes.
+ * @retval None.
+ */
+static void OPENBL_SPI_StartTransmission(void)
+{
+  LL_DMA_InitTypeDef DMA_InitStruct;
+
+  DMA_InitStruct.PeriphOrM2MSrcAddress  = LL_SPI_DMA_GetRegAddr(SPIx);
+  DMA_InitStruct.MemoryOrM2MDstAddress  = 0U;
+  DMA_InitStruct.Direction              = LL_DMA_DIRECTION_MEMORY_TO_PERIPH;
+  DMA_InitStruct.Mode                   = LL_DMA_MODE_NORMAL;
+  DMA_InitStruct.PeriphOrM2MSrcIncMode  = LL_DMA_PERIPH_NOINCREMENT;
+  DMA_InitStruct.MemoryOrM2MDstIncMode  = LL_DMA_MEMORY_INCREMENT;
+  DMA_InitStruct.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE;
+  DMA_InitStruct.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE;
+  DMA_InitStruct.NbData                 = 0U;
+  DMA_InitStruct.PeriphRequest          = SPIx_TX_DMA_REQUEST;
+  DMA_InitStruct.Priority               = LL_DMA_PRIORITY_HIGH;
+
+  LL_DMA_Init(SPIx_DMAx, SPIx_TX_DMA_CHANNEL, &DMA_InitStruct);
+}
+
+/**
+ * @brief  This function is used to get the position of the next byte written by the DMA in the ring buffer.
+ * @retval Returns the write position.
+ */
+static uint32_t OPENBL_SPI_GetRxHead(void)
+{
+  return (SPI_RX_BUFFER_SIZE - LL_DMA_GetDataLength(SPIx_DMAx, SPIx_RX_DMA_CHANNEL)) % SPI_RX_BUFFER_SIZE;
+}
+
+/**
+ * @brief  This function is used to wait for data in the receive ring buffer.
+ * @note   A system reset occurs if the host does not send any data before the timeout.
+ * @param  Timeout The time in us waited for data, 0 to wait without time limit.
+ * @retval Returns the number of bytes that can be read contiguously from the ring buffer.
+ */
+static uint32_t OPENBL_SPI_WaitRxData(uint32_t Timeout)
+{
+  uint32_t deadline = Common_StartTimeout(Timeout);
+  uint32_t head     = OPENBL_SPI_GetRxHead();
+
+  while (head == SpiRxTail)
+  {
+    OPENBL_IWDG_Refresh();
+
+    if ((Timeout != 0U) && (Common_IsTimeoutElapsed(deadline) == SET))
+    {
+      Common_SystemReset();
+    }
+
+    head = OPENBL_SPI_GetRxHead();
+  }
+
+  return (head > SpiRxTail) ? (head - SpiRxTail) : (SPI_RX_BUFFER_SIZE - SpiRxTail);
+}
+
+/**
+ * @brief  This function is used to send the response of a special command.
+ * @param  pData Pointer to the data to be sent, can be NULL if DataSize is 0.
+ * @param  DataSize Number of data bytes.
+ * @param  Status Status byte sent after the data.
+ * @retval None.
+ */
+static void OPENBL_SPI_SendSpecialCmdResponse(uint8_t *pData, uint16_t DataSize, uint8_t Status)
+{
+  /* Send data size */
+  OPENBL_SPI_SendByte((uint8_t)(DataSize >> 8U));
+  OPENBL_SPI_SendByte((uint8_t)(DataSize & 0xFFU));
+
+  /* Send data */
+  OPENBL_SPI_SendBytes(pData, DataSize);
+
+  /* Send status size */
+  OPENBL_SPI_SendByte(0x00U);
+  OPENBL_SPI_SendByte(0x01U);
+
+  /* Send status */
+  OPENBL_SPI_SendByte(Status);
+}
+
 /* Exported functions --------------------------------------------------------*/
 
 /**
@@ -162,8 +287,9 @@ uint8_t OPENBL_SPI_ProtocolDetection(void)
     {
       SpiDetected = 1U;
 
-      /* Enable the interrupt of Rx not empty buffer */
-      LL_SPI_EnableIT_RXNE(SPIx);
+      /* The next bytes are received in the DMA ring buffer and the data blocks are sent by DMA */
+      OPENBL_SPI_StartReception();
+      OPENBL_SPI_StartTransmission();
 
       /* Send synchronization byte */
       OPENBL_SPI_SendByte(SYNC_BYTE);
@@ -193,11 +319,13 @@ uint8_t OPENBL_SPI_GetCommandOpcode(void)
   uint8_t command_opc;
 
   /* Disable busy byte */
-  BusyState = 0U;
+  OPENBL_SPI_DisableBusyState();
 
-  /* Check if there is any activity on SPI */
-  while (OPENBL_SPI_ReadByte() != SPI_SYNC_BYTE)
-  {}
+  /* Wait for the synchronization byte of the next command without time limit */
+  do
+  {
+    (void)OPENBL_SPI_WaitRxData(0U);
+  } while (OPENBL_SPI_ReadByte() != SPI_SYNC_BYTE);
 
   /* Get the command opcode */
   command_opc = OPENBL_SPI_ReadByte();
@@ -213,65 +341,48 @@ uint8_t OPENBL_SPI_GetCommandOpcode(void)
 
 /**
   * @brief  This function is used to read one byte from SPI pipe.
-  *         Read operation is synchronized on SPI Rx buffer not empty interrupt.
+  *         The byte is taken from the DMA receive ring buffer, so the function runs from FLASH
+  *         as the reception goes on by DMA while the FLASH is busy.
   * @retval Returns the read byte.
   */
-#if defined (__ICCARM__)
-__ramfunc uint8_t OPENBL_SPI_ReadByte(void)
-#else
-__attribute__((section(".ramfunc"))) uint8_t OPENBL_SPI_ReadByte(void)
-#endif /* (__ICCARM__) */
+uint8_t OPENBL_SPI_ReadByte(void)
 {
   uint8_t data;
 
-  /* Wait until SPI Rx buffer not empty interrupt */
-  while (SpiRxNotEmpty == 0U)
-  {
-    /* Refresh IWDG: reload counter */
-    IWDG->KR = IWDG_KEY_RELOAD;
-  }
-
-  /* Reset the RX not empty token */
-  SpiRxNotEmpty = 0U;
-
-  /* Read the SPI data register */
-  data = SPIx->DR;
+  (void)OPENBL_SPI_WaitRxData(OPENBL_SPI_TIMEOUT);
 
-  /* Enable the interrupt of Rx not empty buffer */
-  SPIx->CR2 |= SPI_CR2_RXNEIE;
+  data      = SpiRxBuffer[SpiRxTail];
+  SpiRxTail = (SpiRxTail + 1U) % SPI_RX_BUFFER_SIZE;
 
   return data;
 }
 
 /**
-  * @brief  This function is used to send one busy byte each receive interrupt through SPI pipe.
-  *         Read operation is synchronized on SPI Rx buffer not empty interrupt.
-  * @retval Returns the read byte.
+  * @brief  This function is used to read a block of bytes from SPI pipe.
+  * @note   The bytes are copied from the receive ring buffer as soon as they are available.
+  * @param  pBuffer Pointer to the buffer receiving the bytes.
+  * @param  Length The number of bytes to read.
+  * @retval None.
   */
-#if defined (__ICCARM__)
-__ramfunc void OPENBL_SPI_SendBusyByte(void)
-#else
-__attribute__((section(".ramfunc"))) void OPENBL_SPI_SendBusyByte(void)
-#endif /* (__ICCARM__) */
+void OPENBL_SPI_ReadBytes(uint8_t *pBuffer, uint32_t Length)
 {
-  /* Wait until SPI Rx buffer not empty interrupt */
-  while (SpiRxNotEmpty == 0U)
-  {
-    /* Refresh IWDG: reload counter */
-    IWDG->KR = IWDG_KEY_RELOAD;
-  }
+  uint32_t index;
+  uint32_t count;
 
-  /* Reset the RX not empty token */
-  SpiRxNotEmpty = 0U;
-
-  /* Transmit the busy byte */
-  *((__IO uint8_t *)&SPIx->DR) = SPI_BUSY_BYTE;
+  while (Length > 0U)
+  {
+    count = OPENBL_SPI_WaitRxData(OPENBL_SPI_TIMEOUT);
+    count = (count > Length) ? Length : count;
 
-  /* Read bytes from the host to avoid the overrun */
-  OPENBL_SPI_ClearFlag_OVR();
+    for (index = 0U; index < count; index++)
+    {
+      pBuffer[index] = SpiRxBuffer[SpiRxTail + index];
+    }
 
-  /* Enable the interrupt of Rx not empty buffer */
-  SPIx->CR2 |= SPI_CR2_RXNEIE;
+    SpiRxTail = (SpiRxTail + count) % SPI_RX_BUFFER_SIZE;
+    pBuffer  += count;
+    Length   -= count;
+  }
 }
 
 /**
@@ -284,14 +395,78 @@ __ramfunc void OPENBL_SPI_SendByte(uint8_t Byte)
 __attribute__((section(".ramfunc"))) void OPENBL_SPI_SendByte(uint8_t Byte)
 #endif /* (__ICCARM__) */
 {
+  uint32_t deadline = Common_StartTimeout(OPENBL_SPI_TIMEOUT);
+
   /* Wait until SPI transmit buffer is empty */
   while ((SPIx->SR & SPI_SR_TXE) == 0U)
-  {}
+  {
+    if (Common_IsTimeoutElapsed(deadline) == SET)
+    {
+      Common_SystemReset();
+    }
+  }
 
   /* Transmit the data */
   *((__IO uint8_t *)&SPIx->DR) = Byte;
 }
 
+/**
+  * @brief  This function is used to send a block of bytes through SPI pipe.
+  * @note   The bytes are written in the SPI transmit FIFO by DMA as the host clocks them out,
+  *         the function returns once the DMA has read the whole buffer. When the buffer is
+  *         half-word aligned, the DMA packs two 8-bit frames per access to halve the number
+  *         of DMA requests, the frames on the bus are unchanged.
+  * @param  pBuffer Pointer to the bytes to be sent.
+  * @param  Length The number of bytes to send.
+  * @retval None.
+  */
+void OPENBL_SPI_SendBytes(uint8_t *pBuffer, uint32_t Length)
+{
+  uint32_t count = Length;
+  uint32_t deadline;
+
+  if (Length != 0U)
+  {
+    if ((Length > 1U) && (((uint32_t)pBuffer & 0x1U) == 0U))
+    {
+      LL_DMA_SetPeriphSize(SPIx_DMAx, SPIx_TX_DMA_CHANNEL, LL_DMA_PDATAALIGN_HALFWORD);
+      LL_DMA_SetMemorySize(SPIx_DMAx, SPIx_TX_DMA_CHANNEL, LL_DMA_MDATAALIGN_HALFWORD);
+
+      /* The last half-word carries a single frame when the length is odd */
+      LL_SPI_SetDMAParity_TX(SPIx, ((Length & 0x1U) != 0U) ? LL_SPI_DMA_PARITY_ODD : LL_SPI_DMA_PARITY_EVEN);
+
+      count = (Length + 1U) / 2U;
+    }
+
+    LL_DMA_SetMemoryAddress(SPIx_DMAx, SPIx_TX_DMA_CHANNEL, (uint32_t)pBuffer);
+    LL_DMA_SetDataLength(SPIx_DMAx, SPIx_TX_DMA_CHANNEL, count);
+    LL_DMA_EnableChannel(SPIx_DMAx, SPIx_TX_DMA_CHANNEL);
+    LL_SPI_EnableDMAReq_TX(SPIx);
+
+    /* The host clocks the bytes out, the timeout starts once they are available */
+    deadline = Common_StartTimeout(OPENBL_SPI_TIMEOUT);
+
+    while (SPIx_TX_DMA_IsActiveFlag_TC() == 0U)
+    {
+      OPENBL_IWDG_Refresh();
+
+      if (Common_IsTimeoutElapsed(deadline) == SET)
+      {
+        Common_SystemReset();
+      }
+    }
+
+    LL_SPI_DisableDMAReq_TX(SPIx);
+    SPIx_TX_DMA_ClearFlag_GI();
+    LL_DMA_DisableChannel(SPIx_DMAx, SPIx_TX_DMA_CHANNEL);
+
+    /* Restore the byte accesses used by the busy state */
+    LL_DMA_SetPeriphSize(SPIx_DMAx, SPIx_TX_DMA_CHANNEL, LL_DMA_PDATAALIGN_BYTE);
+    LL_DMA_SetMemorySize(SPIx_DMAx, SPIx_TX_DMA_CHANNEL, LL_DMA_MDATAALIGN_BYTE);
+    LL_SPI_SetDMAParity_TX(SPIx, LL_SPI_DMA_PARITY_EVEN);
+  }
+}
+
 /**
   * @brief  This function is used to send acknowledge byte through SPI pipe.
   * @retval None.
@@ -311,86 +486,50 @@ void OPENBL_SPI_SendAcknowledgeByte(uint8_t Byte)
 }
 
 /**
-  * @brief  Handle SPI interrupt request.
+  * @brief  This function enables the send of busy state.
+  * @note   The TX DMA channel sends the busy byte in circular mode for each byte clocked by the host,
+  *         so that no CPU time is needed while the FLASH is being programmed or erased. The ready/busy
+  *         line is driven low until the busy state is disabled.
   * @retval None.
   */
-#if defined (__ICCARM__)
-__ramfunc void OPENBL_SPI_IRQHandler(void)
-#else
-__attribute__((section(".ramfunc"))) void OPENBL_SPI_IRQHandler(void)
-#endif /* (__ICCARM__) */
+void OPENBL_SPI_EnableBusyState(void)
 {
-  /* Check that SPI Rx buffer not empty interrupt has been raised */
-  if (((SPIx->SR & SPI_SR_OVR) == RESET)
-      && ((SPIx->SR & SPI_SR_RXNE) != RESET)
-      && ((SPIx->CR2 & SPI_CR2_RXNEIE) != RESET))
+  if (BusyState == 0U)
   {
-    if (BusyState == 0U)
-    {
-      /* Set the RX not empty token */
-      SpiRxNotEmpty = 1U;
-
-      /* Disable the interrupt of Rx not empty buffer */
-      SPIx->CR2 &= ~ SPI_CR2_RXNEIE;
-    }
-    else
-    {
-      /* Set the RX not empty token */
-      SpiRxNotEmpty = 1U;
-
-      /* Disable the interrupt of Rx not empty buffer */
-      SPIx->CR2 &= ~ SPI_CR2_RXNEIE;
+    BusyState = 1U;
 
-      /* Send busy byte */
-      OPENBL_SPI_SendBusyByte();
-    }
-  }
+    Common_SetBusy();
 
-  while (((SPIx->SR & SPI_SR_OVR) != RESET)
-         && ((SPIx->SR & SPI_SR_RXNE) != RESET)
-         && ((SPIx->CR2 & SPI_CR2_RXNEIE) != RESET))
-  {
-    /* Read bytes from the host to avoid the overrun */
-    OPENBL_SPI_ClearFlag_OVR();
+    LL_DMA_SetMode(SPIx_DMAx, SPIx_TX_DMA_CHANNEL, LL_DMA_MODE_CIRCULAR);
+    LL_DMA_SetMemoryIncMode(SPIx_DMAx, SPIx_TX_DMA_CHANNEL, LL_DMA_MEMORY_NOINCREMENT);
+    LL_DMA_SetMemoryAddress(SPIx_DMAx, SPIx_TX_DMA_CHANNEL, (uint32_t)&SpiBusyByte);
+    LL_DMA_SetDataLength(SPIx_DMAx, SPIx_TX_DMA_CHANNEL, 1U);
+    LL_DMA_EnableChannel(SPIx_DMAx, SPIx_TX_DMA_CHANNEL);
+    LL_SPI_EnableDMAReq_TX(SPIx);
   }
 }
 
-/**
-  * @brief  This function enables the send of busy state.
-  * @retval None.
-  */
-void OPENBL_SPI_EnableBusyState(void)
-{
-  BusyState = 1U;
-}
-
 /**
   * @brief  This function disables the send of busy state.
+  * @note   The bytes clocked by the host to poll the busy state are dropped.
   * @retval None.
   */
 void OPENBL_SPI_DisableBusyState(void)
 {
-  BusyState = 0U;
-}
+  if (BusyState != 0U)
+  {
+    BusyState = 0U;
 
-/**
-  * @brief  Clear overrun error flag
-  * @note   Clearing this flag is done by a read access to the SPIx_DR
-  *         register followed by a read access to the SPIx_SR register
-  * @retval None
-  */
-#if defined (__ICCARM__)
-__ramfunc void OPENBL_SPI_ClearFlag_OVR(void)
-#else
-__attribute__((section(".ramfunc"))) void OPENBL_SPI_ClearFlag_OVR(void)
-#endif /* (__ICCARM__) */
-{
-  __IO uint32_t tmpreg;
+    LL_SPI_DisableDMAReq_TX(SPIx);
+    LL_DMA_DisableChannel(SPIx_DMAx, SPIx_TX_DMA_CHANNEL);
+    SPIx_TX_DMA_ClearFlag_GI();
+    LL_DMA_SetMode(SPIx_DMAx, SPIx_TX_DMA_CHANNEL, LL_DMA_MODE_NORMAL);
+    LL_DMA_SetMemoryIncMode(SPIx_DMAx, SPIx_TX_DMA_CHANNEL, LL_DMA_MEMORY_INCREMENT);
+
+    SpiRxTail = OPENBL_SPI_GetRxHead();
 
-  tmpreg = SPIx->DR;
-  (void) tmpreg;
-  tmpreg = SPIx->SR;
-  (void) tmpreg;
+    Common_SetReady();
+  }
 }
 
 /**
@@ -401,8 +540,167 @@ __attribute__((section(".ramfunc"))) void OPENBL_SPI_ClearFlag_OVR(void)
  */
 void OPENBL_SPI_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *SpecialCmd)
 {
+  ErrorStatus status;
+  uint32_t crc = 0U;
+  uint32_t length = 0U;
+  uint8_t data[HASH_SHA256_DIGEST_SIZE];
+
   switch (SpecialCmd->OpCode)
   {
+    /* Swap the FLASH banks */
+    case SPECIAL_CMD_SWAP_BANK:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_FLASH_SwapBank(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_SPI_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_SPI_SendByte(0x00U);
+        OPENBL_SPI_SendByte(0x00U);
+      }
+      break;
+
+    /* Compute the CRC32 of a memory region */
+    case SPECIAL_CMD_CRC32:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_CRC_ComputeRegion(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, &crc);
+
+        data[0] = (uint8_t)(crc & 0xFFU);
+        data[1] = (uint8_t)((crc >> 8U) & 0xFFU);
+        data[2] = (uint8_t)((crc >> 16U) & 0xFFU);
+        data[3] = (uint8_t)((crc >> 24U) & 0xFFU);
+
+        if (status == SUCCESS)
+        {
+          OPENBL_SPI_SendSpecialCmdResponse(data, 4U, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_SPI_SendSpecialCmdResponse(NULL, 0U, NACK_BYTE);
+        }
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_SPI_SendByte(0x00U);
+        OPENBL_SPI_SendByte(0x00U);
+      }
+      break;
+
+    /* Compute the SHA-256 digest of a memory region */
+    case SPECIAL_CMD_SHA256:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_HASH_ComputeRegion(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, data);
+
+        if (status == SUCCESS)
+        {
+          OPENBL_SPI_SendSpecialCmdResponse(data, HASH_SHA256_DIGEST_SIZE, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_SPI_SendSpecialCmdResponse(NULL, 0U, NACK_BYTE);
+        }
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_SPI_SendByte(0x00U);
+        OPENBL_SPI_SendByte(0x00U);
+      }
+      break;
+
+    /* Write a compressed stream decompressed in FLASH */
+    case SPECIAL_CMD_DECOMPRESS:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_DECOMPRESS_Control(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, &length);
+
+        if ((status == SUCCESS) && (SpecialCmd->Buffer1[0] == DECOMPRESS_CMD_END))
+        {
+          /* Send the number of decompressed bytes */
+          data[0] = (uint8_t)(length & 0xFFU);
+          data[1] = (uint8_t)((length >> 8U) & 0xFFU);
+          data[2] = (uint8_t)((length >> 16U) & 0xFFU);
+          data[3] = (uint8_t)((length >> 24U) & 0xFFU);
+
+          OPENBL_SPI_SendSpecialCmdResponse(data, 4U, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_SPI_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+        }
+      }
+      else
+      {
+        status = OPENBL_DECOMPRESS_Feed(SpecialCmd->Buffer2, SpecialCmd->SizeBuffer2);
+
+        /* Send status size and status */
+        OPENBL_SPI_SendByte(0x00U);
+        OPENBL_SPI_SendByte(0x01U);
+        OPENBL_SPI_SendByte((status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+      }
+      break;
+
+    /* Write a new image built from a patch of an image in FLASH */
+    case SPECIAL_CMD_PATCH:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_PATCH_Control(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, &length);
+
+        if ((status == SUCCESS) && (SpecialCmd->Buffer1[0] == PATCH_CMD_END))
+        {
+          /* Send the length of the new image */
+          data[0] = (uint8_t)(length & 0xFFU);
+          data[1] = (uint8_t)((length >> 8U) & 0xFFU);
+          data[2] = (uint8_t)((length >> 16U) & 0xFFU);
+          data[3] = (uint8_t)((length >> 24U) & 0xFFU);
+
+          OPENBL_SPI_SendSpecialCmdResponse(data, 4U, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_SPI_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+        }
+      }
+      else
+      {
+        status = OPENBL_PATCH_Feed(SpecialCmd->Buffer2, SpecialCmd->SizeBuffer2);
+
+        /* Send status size and status */
+        OPENBL_SPI_SendByte(0x00U);
+        OPENBL_SPI_SendByte(0x01U);
+        OPENBL_SPI_SendByte((status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+      }
+      break;
+
+    /* Read the FLASH statistics */
+    case SPECIAL_CMD_FLASH_STATS:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_FLASH_GetStatistics(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, data);
+
+        if (status == SUCCESS)
+        {
+          OPENBL_SPI_SendSpecialCmdResponse(data, FLASH_STATS_SIZE, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_SPI_SendSpecialCmdResponse(NULL, 0U, NACK_BYTE);
+        }
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_SPI_SendByte(0x00U);
+        OPENBL_SPI_SendByte(0x00U);
+      }
+      break;
+
     /* Unknown command opcode */
     default:
       if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
@@ -41,17 +41,14 @@ void OPENBL_SPI_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *Frame);
 
 void OPENBL_SPI_EnableBusyState(void);
 void OPENBL_SPI_DisableBusyState(void);
+uint8_t OPENBL_SPI_ReadByte(void);
+void OPENBL_SPI_ReadBytes(uint8_t *pBuffer, uint32_t Length);
+void OPENBL_SPI_SendBytes(uint8_t *pBuffer, uint32_t Length);
 
 #if defined (__ICCARM__)
-__ramfunc uint8_t OPENBL_SPI_ReadByte(void);
 __ramfunc void OPENBL_SPI_SendByte(uint8_t Byte);
-__ramfunc void OPENBL_SPI_IRQHandler(void);
-__ramfunc void OPENBL_SPI_SendBusyByte(void);
 #else
-__attribute__((section(".ramfunc"))) uint8_t OPENBL_SPI_ReadByte(void);
 __attribute__((section(".ramfunc"))) void OPENBL_SPI_SendByte(uint8_t Byte);
-__attribute__((section(".ramfunc"))) void OPENBL_SPI_IRQHandler(void);
-__attribute__((section(".ramfunc"))) void OPENBL_SPI_SendBusyByte(void);
 #endif /* (__ICCARM__) */
 
 #ifdef __cplusplus
@@ -20,19 +20,63 @@
 #include "platform.h"
 #include "openbl_core.h"
 #include "openbl_usart_cmd.h"
+#include "app_openbootloader.h"
+#include "common_interface.h"
 #include "usart_interface.h"
+#include "flash_interface.h"
+#include "crc_interface.h"
+#include "decompress_interface.h"
+#include "hash_interface.h"
+#include "patch_interface.h"
+#include "window_interface.h"
 #include "iwdg_interface.h"
 #include "interfaces_conf.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+#define USART_RX_BUFFER_SIZE              1024U  /* Size of the DMA receive ring buffer */
+#define USART_BAUDRATE_TIMEOUT            1000U  /* Time in ms to get a frame at a new baud rate */
+/* The level is checked on the DMA half and complete transfer events and on the idle line, so it can grow by half
+   of the ring between two checks: RTS is deasserted at the latest at 3/4 of the ring, leaving 256 bytes to the
+   bytes sent by the host after RTS is deasserted */
+#define USART_RTS_HIGH_LEVEL              (USART_RX_BUFFER_SIZE / 4U)  /* RTS is deasserted from this level */
+#define USART_RTS_LOW_LEVEL               (USART_RX_BUFFER_SIZE / 8U)  /* RTS is asserted again below this level */
+#define USART_WINDOW_MAX_PACKETS          (USART_RX_BUFFER_SIZE / (WINDOW_PACKET_SIZE + 4U))  /* Fit in the ring */
+#define USART_DROP_TIME                   10U  /* Time in ms without data ending the packets dropped on error */
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static uint8_t UsartDetected = 0U;
+static uint8_t UsartRxBuffer[USART_RX_BUFFER_SIZE];
+static uint32_t UsartRxTail = 0U;
+static __IO uint8_t UsartRxEvent = 0U;
+static uint32_t UsartBaudRate = 0U;
+static uint32_t UsartOldBrr = 0U;
+static uint32_t UsartOldOverSampling = LL_USART_OVERSAMPLING_16;
+static FlagStatus UsartBaudRateCheck = RESET;
+static FunctionalState UsartFlowControl = DISABLE;
+static FunctionalState UsartFlowControlRequest = DISABLE;
+static FlagStatus UsartFlowControlPending = RESET;
+static __IO FlagStatus UsartRtsDeasserted = RESET;
+static uint8_t UsartPacket[WINDOW_PACKET_SIZE];
 
 /* Exported variables --------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 static void OPENBL_USART_Init(void);
+static void OPENBL_USART_StartReception(void);
+static void OPENBL_USART_StartTransmission(void);
+static uint32_t OPENBL_USART_GetRxHead(void);
+static uint32_t OPENBL_USART_WaitRxData(uint32_t Timeout);
+static void OPENBL_USART_WaitTransmissionComplete(void);
+static ErrorStatus OPENBL_USART_RequestBaudRate(uint8_t *pData, uint32_t DataLength);
+static void OPENBL_USART_ApplyBaudRate(void);
+static void OPENBL_USART_RestoreBaudRate(void);
+static ErrorStatus OPENBL_USART_RequestFlowControl(uint8_t *pData, uint32_t DataLength);
+static void OPENBL_USART_ApplyFlowControl(void);
+static void OPENBL_USART_ReleaseRts(void);
+static void OPENBL_USART_DropRxData(void);
+static void OPENBL_USART_WindowWrite(void);
+static void OPENBL_USART_SendSpecialCmdResponse(uint8_t *pData, uint16_t DataSize, uint8_t Status);
 
 /* Private functions ---------------------------------------------------------*/
 
@@ -65,9 +109,489 @@ static void OPENBL_USART_Init(void)
   }
 
   LL_USART_Init(USARTx, &USART_InitStruct);
+
+  /* The receive ring buffer is drained by DMA, an overrun must not stop the reception */
+  LL_USART_DisableOverrunDetect(USARTx);
+
+  LL_USART_Enable(USARTx);
+}
+
+/**
+ * @brief  This function is used to start the reception of the USART data in the DMA ring buffer.
+ * @note   The DMA half and full transfer interrupts and the USART idle line interrupt notify
+ *         the reader that data is available.
+ * @retval None.
+ */
+static void OPENBL_USART_StartReception(void)
+{
+  LL_DMA_InitTypeDef DMA_InitStruct;
+
+  USARTx_DMA_CLK_ENABLE();
+  USARTx_DMAMUX_CLK_ENABLE();
+
+  DMA_InitStruct.PeriphOrM2MSrcAddress  = LL_USART_DMA_GetRegAddr(USARTx, LL_USART_DMA_REG_DATA_RECEIVE);
+  DMA_InitStruct.MemoryOrM2MDstAddress  = (uint32_t)UsartRxBuffer;
+  DMA_InitStruct.Direction              = LL_DMA_DIRECTION_PERIPH_TO_MEMORY;
+  DMA_InitStruct.Mode                   = LL_DMA_MODE_CIRCULAR;
+  DMA_InitStruct.PeriphOrM2MSrcIncMode  = LL_DMA_PERIPH_NOINCREMENT;
+  DMA_InitStruct.MemoryOrM2MDstIncMode  = LL_DMA_MEMORY_INCREMENT;
+  DMA_InitStruct.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE;
+  DMA_InitStruct.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE;
+  DMA_InitStruct.NbData                 = USART_RX_BUFFER_SIZE;
+  DMA_InitStruct.PeriphRequest          = USARTx_RX_DMA_REQUEST;
+  DMA_InitStruct.Priority               = LL_DMA_PRIORITY_HIGH;
+
+  LL_DMA_Init(USARTx_DMAx, USARTx_RX_DMA_CHANNEL, &DMA_InitStruct);
+  LL_DMA_EnableIT_HT(USARTx_DMAx, USARTx_RX_DMA_CHANNEL);
+  LL_DMA_EnableIT_TC(USARTx_DMAx, USARTx_RX_DMA_CHANNEL);
+  LL_DMA_EnableChannel(USARTx_DMAx, USARTx_RX_DMA_CHANNEL);
+
+  UsartRxTail  = 0U;
+  UsartRxEvent = 0U;
+
+  LL_USART_ClearFlag_IDLE(USARTx);
+  LL_USART_EnableIT_IDLE(USARTx);
+  LL_USART_EnableDMAReq_RX(USARTx);
+
+  HAL_NVIC_SetPriority(USARTx_RX_DMA_IRQn, 0U, 0U);
+  HAL_NVIC_EnableIRQ(USARTx_RX_DMA_IRQn);
+  HAL_NVIC_SetPriority(USARTx_IRQn, 0U, 0U);
+  HAL_NVIC_EnableIRQ(USARTx_IRQn);
+}
+
+/**
+ * @brief  This function is used to configure the DMA channel sending the USART data blocks.
+ * @retval None.
+ */
+static void OPENBL_USART_StartTransmission(void)
+{
+  LL_DMA_InitTypeDef DMA_InitStruct;
+
+  DMA_InitStruct.PeriphOrM2MSrcAddress  = LL_USART_DMA_GetRegAddr(USARTx, LL_USART_DMA_REG_DATA_TRANSMIT);
+  DMA_InitStruct.MemoryOrM2MDstAddress  = 0U;
+  DMA_InitStruct.Direction              = LL_DMA_DIRECTION_MEMORY_TO_PERIPH;
+  DMA_InitStruct.Mode                   = LL_DMA_MODE_NORMAL;
+  DMA_InitStruct.PeriphOrM2MSrcIncMode  = LL_DMA_PERIPH_NOINCREMENT;
+  DMA_InitStruct.MemoryOrM2MDstIncMode  = LL_DMA_MEMORY_INCREMENT;
+  DMA_InitStruct.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE;
+  DMA_InitStruct.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE;
+  DMA_InitStruct.NbData                 = 0U;
+  DMA_InitStruct.PeriphRequest          = USARTx_TX_DMA_REQUEST;
+  DMA_InitStruct.Priority               = LL_DMA_PRIORITY_MEDIUM;
+
+  LL_DMA_Init(USARTx_DMAx, USARTx_TX_DMA_CHANNEL, &DMA_InitStruct);
+}
+
+/**
+ * @brief  This function is used to get the position of the next byte written by the DMA in the ring buffer.
+ * @retval Returns the write position.
+ */
+static uint32_t OPENBL_USART_GetRxHead(void)
+{
+  return (USART_RX_BUFFER_SIZE - LL_DMA_GetDataLength(USARTx_DMAx, USARTx_RX_DMA_CHANNEL)) % USART_RX_BUFFER_SIZE;
+}
+
+/**
+ * @brief  This function is used to wait for data in the receive ring buffer.
+ * @note   The CPU sleeps until the DMA or the USART notify new data, the watchdog is only
+ *         refreshed while waiting instead of once per byte. The cycle counter is stopped while
+ *         the CPU sleeps, so the timeout is measured with the HAL tick which also wakes the CPU up
+ *         once per millisecond. A system reset occurs once the timeout is elapsed.
+ * @param  Timeout The time in us waited for data, rounded up to the millisecond,
+ *         0 to wait without time limit.
+ * @retval Returns the number of bytes that can be read contiguously from the ring buffer.
+ */
+static uint32_t OPENBL_USART_WaitRxData(uint32_t Timeout)
+{
+  uint32_t tick    = HAL_GetTick();
+  uint32_t timeout = (Timeout + 999U) / 1000U;
+  uint32_t head    = OPENBL_USART_GetRxHead();
+
+  while (head == UsartRxTail)
+  {
+    if (UsartRxEvent == 0U)
+    {
+      __WFI();
+    }
+
+    UsartRxEvent = 0U;
+    OPENBL_IWDG_Refresh();
+
+    if ((Timeout != 0U) && ((HAL_GetTick() - tick) > timeout))
+    {
+      Common_SystemReset();
+    }
+
+    head = OPENBL_USART_GetRxHead();
+  }
+
+  return (head > UsartRxTail) ? (head - UsartRxTail) : (USART_RX_BUFFER_SIZE - UsartRxTail);
+}
+
+/**
+ * @brief  This function is used to wait for the end of the transmission of the last sent byte.
+ * @note   A system reset occurs if the host holds CTS for longer than the timeout.
+ * @retval None.
+ */
+static void OPENBL_USART_WaitTransmissionComplete(void)
+{
+  uint32_t deadline = Common_StartTimeout(OPENBL_USART_TIMEOUT);
+
+  while (!LL_USART_IsActiveFlag_TC(USARTx))
+  {
+    if (Common_IsTimeoutElapsed(deadline) == SET)
+    {
+      Common_SystemReset();
+    }
+  }
+}
+
+/**
+ * @brief  This function is used to check the baud rate requested by the host.
+ * @note   The oversampling by 8 is used when the USART clock is less than 16 times the baud rate.
+ *         The baud rate is applied when the next command is received, once the response is sent.
+ * @param  pData The requested baud rate (4 bytes, LSB first).
+ * @param  DataLength The length of the request, must be 4.
+ * @retval Returns SUCCESS if the baud rate can be reached within 2% else returns ERROR.
+ */
+static ErrorStatus OPENBL_USART_RequestBaudRate(uint8_t *pData, uint32_t DataLength)
+{
+  uint32_t clock = USARTx_GetClockFreq();
+  uint32_t baudrate;
+  uint32_t divider;
+  uint32_t reached;
+  ErrorStatus status = ERROR;
+
+  if (DataLength == 4U)
+  {
+    baudrate = (uint32_t)pData[0] | ((uint32_t)pData[1] << 8U) | ((uint32_t)pData[2] << 16U)
+               | ((uint32_t)pData[3] << 24U);
+
+    if ((baudrate != 0U) && ((clock / baudrate) >= 8U))
+    {
+      if ((clock / baudrate) >= 16U)
+      {
+        divider = (clock + (baudrate / 2U)) / baudrate;
+        reached = clock / divider;
+      }
+      else
+      {
+        divider = ((2U * clock) + (baudrate / 2U)) / baudrate;
+        reached = (2U * clock) / divider;
+      }
+
+      if ((((reached > baudrate) ? (reached - baudrate) : (baudrate - reached)) * 50U) <= baudrate)
+      {
+        UsartBaudRate = baudrate;
+        status        = SUCCESS;
+      }
+    }
+  }
+
+  return status;
+}
+
+/**
+ * @brief  This function is used to switch the USART to the baud rate requested by the host.
+ * @note   The previous baud rate is restored if no byte is received within USART_BAUDRATE_TIMEOUT
+ *         or if the first command received is not valid.
+ * @retval None.
+ */
+static void OPENBL_USART_ApplyBaudRate(void)
+{
+  uint32_t clock = USARTx_GetClockFreq();
+  uint32_t oversampling;
+  uint32_t tick;
+
+  oversampling = ((clock / UsartBaudRate) >= 16U) ? LL_USART_OVERSAMPLING_16 : LL_USART_OVERSAMPLING_8;
+
+  UsartOldBrr          = READ_REG(USARTx->BRR);
+  UsartOldOverSampling = LL_USART_GetOverSampling(USARTx);
+
+  /* Complete the response sent at the current baud rate */
+  OPENBL_USART_WaitTransmissionComplete();
+
+  /* The auto baud rate detection must not run again once the USART is enabled */
+  LL_USART_Disable(USARTx);
+  LL_USART_DisableAutoBaudRate(USARTx);
+  LL_USART_SetOverSampling(USARTx, oversampling);
+  LL_USART_SetBaudRate(USARTx, clock, LL_USART_PRESCALER_DIV1, oversampling, UsartBaudRate);
+  LL_USART_Enable(USARTx);
+
+  UsartBaudRate = 0U;
+  UsartRxTail   = OPENBL_USART_GetRxHead();
+
+  /* Wait for the host to send the next command at the new baud rate */
+  tick = HAL_GetTick();
+
+  while ((OPENBL_USART_GetRxHead() == UsartRxTail) && ((HAL_GetTick() - tick) < USART_BAUDRATE_TIMEOUT))
+  {
+    __WFI();
+    OPENBL_IWDG_Refresh();
+  }
+
+  if (OPENBL_USART_GetRxHead() == UsartRxTail)
+  {
+    OPENBL_USART_RestoreBaudRate();
+  }
+  else
+  {
+    UsartBaudRateCheck = SET;
+  }
+}
+
+/**
+ * @brief  This function is used to restore the baud rate used before the last switch.
+ * @note   The bytes received at the new baud rate are discarded.
+ * @retval None.
+ */
+static void OPENBL_USART_RestoreBaudRate(void)
+{
+  OPENBL_USART_WaitTransmissionComplete();
+
+  LL_USART_Disable(USARTx);
+  LL_USART_SetOverSampling(USARTx, UsartOldOverSampling);
+  WRITE_REG(USARTx->BRR, UsartOldBrr);
+  LL_USART_Enable(USARTx);
+
+  UsartRxTail = OPENBL_USART_GetRxHead();
+}
+
+/**
+ * @brief  This function is used to check the flow control state requested by the host.
+ * @note   The flow control is applied when the next command is received, once the response is sent.
+ * @param  pData The requested state, 0x00 to disable and 0x01 to enable the RTS/CTS flow control.
+ * @param  DataLength The length of the request, must be 1.
+ * @retval Returns SUCCESS if the request is valid else returns ERROR.
+ */
+static ErrorStatus OPENBL_USART_RequestFlowControl(uint8_t *pData, uint32_t DataLength)
+{
+  ErrorStatus status = ERROR;
+
+  if ((DataLength == 1U) && (pData[0] <= 1U))
+  {
+    UsartFlowControlRequest = (pData[0] == 1U) ? ENABLE : DISABLE;
+    UsartFlowControlPending = SET;
+
+    status = SUCCESS;
+  }
+
+  return status;
+}
+
+/**
+ * @brief  This function is used to enable or disable the RTS/CTS flow control.
+ * @note   CTS is handled by the USART to hold the transmission. RTS is a GPIO deasserted when
+ *         the receive ring buffer fills up, as the USART only drives it from its data register.
+ * @retval None.
+ */
+static void OPENBL_USART_ApplyFlowControl(void)
+{
+  GPIO_InitTypeDef GPIO_InitStruct;
+
+  UsartFlowControlPending = RESET;
+
+  /* Complete the response sent without the new flow control */
+  OPENBL_USART_WaitTransmissionComplete();
+
+  LL_USART_Disable(USARTx);
+
+  if (UsartFlowControlRequest == ENABLE)
+  {
+    USARTx_GPIO_CLK_CTS_ENABLE();
+    USARTx_GPIO_CLK_RTS_ENABLE();
+
+    GPIO_InitStruct.Pin       = USARTx_CTS_PIN;
+    GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull      = GPIO_PULLUP;
+    GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_HIGH;
+    GPIO_InitStruct.Alternate = USARTx_ALTERNATE;
+    HAL_GPIO_Init(USARTx_CTS_GPIO_PORT, &GPIO_InitStruct);
+
+    /* RTS is asserted (low) while there is room in the receive ring buffer */
+    HAL_GPIO_WritePin(USARTx_RTS_GPIO_PORT, USARTx_RTS_PIN, GPIO_PIN_RESET);
+
+    GPIO_InitStruct.Pin       = USARTx_RTS_PIN;
+    GPIO_InitStruct.Mode      = GPIO_MODE_OUTPUT_PP;
+    GPIO_InitStruct.Pull      = GPIO_NOPULL;
+    GPIO_InitStruct.Alternate = 0U;
+    HAL_GPIO_Init(USARTx_RTS_GPIO_PORT, &GPIO_InitStruct);
+
+    LL_USART_EnableCTSHWFlowCtrl(USARTx);
+  }
+  else if (UsartFlowControl == ENABLE)
+  {
+    LL_USART_DisableCTSHWFlowCtrl(USARTx);
+
+    HAL_GPIO_DeInit(USARTx_CTS_GPIO_PORT, USARTx_CTS_PIN);
+    HAL_GPIO_DeInit(USARTx_RTS_GPIO_PORT, USARTx_RTS_PIN);
+  }
+  else
+  {
+    /* The flow control is already disabled, the pins are not used by the USART */
+  }
+
+  UsartRtsDeasserted = RESET;
+  UsartFlowControl   = UsartFlowControlRequest;
+
   LL_USART_Enable(USARTx);
 }
 
+/**
+ * @brief  This function is used to assert RTS again once enough bytes are read from the ring buffer.
+ * @retval None.
+ */
+static void OPENBL_USART_ReleaseRts(void)
+{
+  if ((UsartRtsDeasserted == SET)
+      && (((OPENBL_USART_GetRxHead() - UsartRxTail) % USART_RX_BUFFER_SIZE) < USART_RTS_LOW_LEVEL))
+  {
+    UsartRtsDeasserted = RESET;
+
+    HAL_GPIO_WritePin(USARTx_RTS_GPIO_PORT, USARTx_RTS_PIN, GPIO_PIN_RESET);
+  }
+}
+
+/**
+ * @brief  This function is used to deassert RTS when the receive ring buffer fills up.
+ * @note   It is inlined in the interrupt handlers, which run from SRAM during the FLASH erase.
+ * @retval None.
+ */
+__STATIC_FORCEINLINE void OPENBL_USART_CheckRts(void)
+{
+  uint32_t head;
+
+  /* Ask the host to stop sending while the reader is late, typically during a FLASH erase */
+  if (UsartFlowControl == ENABLE)
+  {
+    head = (USART_RX_BUFFER_SIZE - LL_DMA_GetDataLength(USARTx_DMAx, USARTx_RX_DMA_CHANNEL)) % USART_RX_BUFFER_SIZE;
+
+    if (((head - UsartRxTail) % USART_RX_BUFFER_SIZE) >= USART_RTS_HIGH_LEVEL)
+    {
+      UsartRtsDeasserted = SET;
+
+      USARTx_RTS_GPIO_PORT->BSRR = USARTx_RTS_PIN;
+    }
+  }
+}
+
+/**
+ * @brief  This function is used to drop the received bytes until the host stops sending.
+ * @retval None.
+ */
+static void OPENBL_USART_DropRxData(void)
+{
+  uint32_t tick = HAL_GetTick();
+
+  while ((HAL_GetTick() - tick) < USART_DROP_TIME)
+  {
+    if (OPENBL_USART_GetRxHead() != UsartRxTail)
+    {
+      UsartRxTail = OPENBL_USART_GetRxHead();
+      tick        = HAL_GetTick();
+    }
+
+    OPENBL_IWDG_Refresh();
+  }
+
+  OPENBL_USART_ReleaseRts();
+}
+
+/**
+ * @brief  This function is used to receive the packets of a windowed write.
+ * @note   A packet is its sequence number, its data length (2 bytes, MSB first, 0 for the end packet),
+ *         its data and the XOR of all its previous bytes. The packets are acknowledged with ACK followed
+ *         by the next expected sequence number, twice per window and after the end packet. On error,
+ *         NACK is sent followed by the first failed sequence number and the packets in flight are dropped.
+ * @retval None.
+ */
+static void OPENBL_USART_WindowWrite(void)
+{
+  uint32_t index;
+  uint32_t length;
+  uint8_t sequence;
+  uint8_t checksum;
+  ErrorStatus status = SUCCESS;
+  FlagStatus end     = RESET;
+
+  while ((status == SUCCESS) && (end == RESET))
+  {
+    sequence = OPENBL_USART_ReadByte();
+    length   = (uint32_t)OPENBL_USART_ReadByte() << 8U;
+    length  |= (uint32_t)OPENBL_USART_ReadByte();
+    checksum = sequence ^ (uint8_t)(length >> 8U) ^ (uint8_t)length;
+
+    if (length > WINDOW_PACKET_SIZE)
+    {
+      status = ERROR;
+    }
+    else
+    {
+      OPENBL_USART_ReadBytes(UsartPacket, length);
+
+      for (index = 0U; index < length; index++)
+      {
+        checksum ^= UsartPacket[index];
+      }
+
+      if (checksum != OPENBL_USART_ReadByte())
+      {
+        status = ERROR;
+      }
+      else if (length == 0U)
+      {
+        status = OPENBL_WINDOW_End(sequence);
+        end    = SET;
+      }
+      else
+      {
+        status = OPENBL_WINDOW_Write(sequence, UsartPacket, length);
+      }
+    }
+
+    if (status == ERROR)
+    {
+      OPENBL_USART_SendByte(NACK_BYTE);
+      OPENBL_USART_SendByte(OPENBL_WINDOW_GetSequence());
+
+      OPENBL_USART_DropRxData();
+    }
+    else if ((end == SET) || (OPENBL_WINDOW_IsAckRequired() == SET))
+    {
+      OPENBL_USART_SendByte(ACK_BYTE);
+      OPENBL_USART_SendByte(OPENBL_WINDOW_GetSequence());
+    }
+    else
+    {
+      /* Keep receiving the packets in flight */
+    }
+  }
+}
+
+/**
+ * @brief  This function is used to send the response of a special command.
+ * @param  pData Pointer to the data to be sent, can be NULL if DataSize is 0.
+ * @param  DataSize Number of data bytes.
+ * @param  Status Status byte sent after the data.
+ * @retval None.
+ */
+static void OPENBL_USART_SendSpecialCmdResponse(uint8_t *pData, uint16_t DataSize, uint8_t Status)
+{
+  /* Send data size */
+  OPENBL_USART_SendByte((uint8_t)(DataSize >> 8U));
+  OPENBL_USART_SendByte((uint8_t)(DataSize & 0xFFU));
+
+  /* Send data */
+  OPENBL_USART_SendBytes(pData, DataSize);
+
+  /* Send status size */
+  OPENBL_USART_SendByte(0x00U);
+  OPENBL_USART_SendByte(0x01U);
+
+  /* Send status */
+  OPENBL_USART_SendByte(Status);
+}
+
 /* Exported functions --------------------------------------------------------*/
 
 /**
@@ -133,7 +657,11 @@ uint8_t OPENBL_USART_ProtocolDetection(void)
   if (((USARTx->ISR & LL_USART_ISR_ABRF) != 0) && ((USARTx->ISR & LL_USART_ISR_ABRE) == 0))
   {
     /* Read byte in order to flush the 0x7F synchronization byte */
-    OPENBL_USART_ReadByte();
+    (void)LL_USART_ReceiveData8(USARTx);
+
+    /* The next bytes are received in the DMA ring buffer and the data blocks are sent by DMA */
+    OPENBL_USART_StartReception();
+    OPENBL_USART_StartTransmission();
 
     /* Acknowledge the host */
     OPENBL_USART_SendByte(ACK_BYTE);
@@ -156,6 +684,21 @@ uint8_t OPENBL_USART_GetCommandOpcode(void)
 {
   uint8_t command_opc;
 
+  /* Apply the flow control requested by the previous command */
+  if (UsartFlowControlPending == SET)
+  {
+    OPENBL_USART_ApplyFlowControl();
+  }
+
+  /* Switch to the baud rate requested by the previous command */
+  if (UsartBaudRate != 0U)
+  {
+    OPENBL_USART_ApplyBaudRate();
+  }
+
+  /* Wait for the next command without time limit, the command bytes are then read with a timeout */
+  (void)OPENBL_USART_WaitRxData(0U);
+
   /* Get the command opcode */
   command_opc = OPENBL_USART_ReadByte();
 
@@ -165,6 +708,17 @@ uint8_t OPENBL_USART_GetCommandOpcode(void)
     command_opc = ERROR_COMMAND;
   }
 
+  /* The first command received at a new baud rate must be valid, else the previous one is restored */
+  if (UsartBaudRateCheck == SET)
+  {
+    UsartBaudRateCheck = RESET;
+
+    if (command_opc == ERROR_COMMAND)
+    {
+      OPENBL_USART_RestoreBaudRate();
+    }
+  }
+
   return command_opc;
 }
 
@@ -174,25 +728,102 @@ uint8_t OPENBL_USART_GetCommandOpcode(void)
   */
 uint8_t OPENBL_USART_ReadByte(void)
 {
-  while (!LL_USART_IsActiveFlag_RXNE(USARTx))
+  uint8_t byte;
+
+  (void)OPENBL_USART_WaitRxData(OPENBL_USART_TIMEOUT);
+
+  byte        = UsartRxBuffer[UsartRxTail];
+  UsartRxTail = (UsartRxTail + 1U) % USART_RX_BUFFER_SIZE;
+
+  OPENBL_USART_ReleaseRts();
+
+  return byte;
+}
+
+/**
+  * @brief  This function is used to read a block of bytes from USART pipe.
+  * @note   The bytes are copied from the receive ring buffer as soon as they are available.
+  * @param  pBuffer Pointer to the buffer receiving the bytes.
+  * @param  Length The number of bytes to read.
+  * @retval None.
+  */
+void OPENBL_USART_ReadBytes(uint8_t *pBuffer, uint32_t Length)
+{
+  uint32_t index;
+  uint32_t count;
+
+  while (Length > 0U)
   {
-    OPENBL_IWDG_Refresh();
-  }
+    count = OPENBL_USART_WaitRxData(OPENBL_USART_TIMEOUT);
+    count = (count > Length) ? Length : count;
+
+    for (index = 0U; index < count; index++)
+    {
+      pBuffer[index] = UsartRxBuffer[UsartRxTail + index];
+    }
+
+    UsartRxTail = (UsartRxTail + count) % USART_RX_BUFFER_SIZE;
+    pBuffer    += count;
+    Length     -= count;
 
-  return LL_USART_ReceiveData8(USARTx);
+    OPENBL_USART_ReleaseRts();
+  }
 }
 
 /**
   * @brief  This function is used to send one byte through USART pipe.
+  * @note   The function returns once the byte is in the transmit data register, so that
+  *         consecutive bytes are sent back-to-back.
   * @param  Byte The byte to be sent.
   * @retval None.
   */
 void OPENBL_USART_SendByte(uint8_t Byte)
 {
+  uint32_t deadline = Common_StartTimeout(OPENBL_USART_TIMEOUT);
+
+  while (!LL_USART_IsActiveFlag_TXE(USARTx))
+  {
+    if (Common_IsTimeoutElapsed(deadline) == SET)
+    {
+      Common_SystemReset();
+    }
+  }
+
   LL_USART_TransmitData8(USARTx, (Byte & 0xFFU));
+}
 
-  while (!LL_USART_IsActiveFlag_TC(USARTx))
+/**
+  * @brief  This function is used to send a block of bytes through USART pipe.
+  * @note   The bytes are sent back-to-back by DMA, the function returns once the DMA has
+  *         read the whole buffer.
+  * @param  pBuffer Pointer to the bytes to be sent.
+  * @param  Length The number of bytes to send.
+  * @retval None.
+  */
+void OPENBL_USART_SendBytes(uint8_t *pBuffer, uint32_t Length)
+{
+  uint32_t deadline;
+
+  if (Length != 0U)
   {
+    deadline = Common_StartTimeout(OPENBL_USART_TIMEOUT);
+
+    LL_DMA_SetMemoryAddress(USARTx_DMAx, USARTx_TX_DMA_CHANNEL, (uint32_t)pBuffer);
+    LL_DMA_SetDataLength(USARTx_DMAx, USARTx_TX_DMA_CHANNEL, Length);
+    LL_DMA_EnableChannel(USARTx_DMAx, USARTx_TX_DMA_CHANNEL);
+    LL_USART_EnableDMAReq_TX(USARTx);
+
+    while (USARTx_TX_DMA_IsActiveFlag_TC() == 0U)
+    {
+      if (Common_IsTimeoutElapsed(deadline) == SET)
+      {
+        Common_SystemReset();
+      }
+    }
+
+    LL_USART_DisableDMAReq_TX(USARTx);
+    USARTx_TX_DMA_ClearFlag_GI();
+    LL_DMA_DisableChannel(USARTx_DMAx, USARTx_TX_DMA_CHANNEL);
   }
 }
 
@@ -204,8 +835,221 @@ void OPENBL_USART_SendByte(uint8_t Byte)
  */
 void OPENBL_USART_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *SpecialCmd)
 {
+  ErrorStatus status;
+  uint32_t crc = 0U;
+  uint32_t length = 0U;
+  uint8_t data[HASH_SHA256_DIGEST_SIZE];
+
   switch (SpecialCmd->OpCode)
   {
+    /* Swap the FLASH banks */
+    case SPECIAL_CMD_SWAP_BANK:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_FLASH_SwapBank(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_USART_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_USART_SendByte(0x00U);
+        OPENBL_USART_SendByte(0x00U);
+      }
+      break;
+
+    /* Compute the CRC32 of a memory region */
+    case SPECIAL_CMD_CRC32:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_CRC_ComputeRegion(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, &crc);
+
+        data[0] = (uint8_t)(crc & 0xFFU);
+        data[1] = (uint8_t)((crc >> 8U) & 0xFFU);
+        data[2] = (uint8_t)((crc >> 16U) & 0xFFU);
+        data[3] = (uint8_t)((crc >> 24U) & 0xFFU);
+
+        if (status == SUCCESS)
+        {
+          OPENBL_USART_SendSpecialCmdResponse(data, 4U, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_USART_SendSpecialCmdResponse(NULL, 0U, NACK_BYTE);
+        }
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_USART_SendByte(0x00U);
+        OPENBL_USART_SendByte(0x00U);
+      }
+      break;
+
+    /* Compute the SHA-256 digest of a memory region */
+    case SPECIAL_CMD_SHA256:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_HASH_ComputeRegion(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, data);
+
+        if (status == SUCCESS)
+        {
+          OPENBL_USART_SendSpecialCmdResponse(data, HASH_SHA256_DIGEST_SIZE, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_USART_SendSpecialCmdResponse(NULL, 0U, NACK_BYTE);
+        }
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_USART_SendByte(0x00U);
+        OPENBL_USART_SendByte(0x00U);
+      }
+      break;
+
+    /* Write a compressed stream decompressed in FLASH */
+    case SPECIAL_CMD_DECOMPRESS:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_DECOMPRESS_Control(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, &length);
+
+        if ((status == SUCCESS) && (SpecialCmd->Buffer1[0] == DECOMPRESS_CMD_END))
+        {
+          /* Send the number of decompressed bytes */
+          data[0] = (uint8_t)(length & 0xFFU);
+          data[1] = (uint8_t)((length >> 8U) & 0xFFU);
+          data[2] = (uint8_t)((length >> 16U) & 0xFFU);
+          data[3] = (uint8_t)((length >> 24U) & 0xFFU);
+
+          OPENBL_USART_SendSpecialCmdResponse(data, 4U, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_USART_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+        }
+      }
+      else
+      {
+        status = OPENBL_DECOMPRESS_Feed(SpecialCmd->Buffer2, SpecialCmd->SizeBuffer2);
+
+        /* Send status size and status */
+        OPENBL_USART_SendByte(0x00U);
+        OPENBL_USART_SendByte(0x01U);
+        OPENBL_USART_SendByte((status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+      }
+      break;
+
+    /* Write a new image built from a patch of an image in FLASH */
+    case SPECIAL_CMD_PATCH:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_PATCH_Control(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, &length);
+
+        if ((status == SUCCESS) && (SpecialCmd->Buffer1[0] == PATCH_CMD_END))
+        {
+          /* Send the length of the new image */
+          data[0] = (uint8_t)(length & 0xFFU);
+          data[1] = (uint8_t)((length >> 8U) & 0xFFU);
+          data[2] = (uint8_t)((length >> 16U) & 0xFFU);
+          data[3] = (uint8_t)((length >> 24U) & 0xFFU);
+
+          OPENBL_USART_SendSpecialCmdResponse(data, 4U, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_USART_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+        }
+      }
+      else
+      {
+        status = OPENBL_PATCH_Feed(SpecialCmd->Buffer2, SpecialCmd->SizeBuffer2);
+
+        /* Send status size and status */
+        OPENBL_USART_SendByte(0x00U);
+        OPENBL_USART_SendByte(0x01U);
+        OPENBL_USART_SendByte((status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+      }
+      break;
+
+    /* Switch the USART to a higher baud rate */
+    case SPECIAL_CMD_BAUDRATE:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_USART_RequestBaudRate(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        /* The response is sent at the current baud rate */
+        OPENBL_USART_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_USART_SendByte(0x00U);
+        OPENBL_USART_SendByte(0x00U);
+      }
+      break;
+
+    /* Enable or disable the USART RTS/CTS flow control */
+    case SPECIAL_CMD_FLOW_CONTROL:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_USART_RequestFlowControl(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_USART_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_USART_SendByte(0x00U);
+        OPENBL_USART_SendByte(0x00U);
+      }
+      break;
+
+    /* Write data with several packets in flight */
+    case SPECIAL_CMD_WINDOW_WRITE:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_WINDOW_Start(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, USART_WINDOW_MAX_PACKETS);
+
+        OPENBL_USART_SendSpecialCmdResponse(NULL, 0U, (status == SUCCESS) ? ACK_BYTE : NACK_BYTE);
+
+        if (status == SUCCESS)
+        {
+          OPENBL_USART_WindowWrite();
+        }
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_USART_SendByte(0x00U);
+        OPENBL_USART_SendByte(0x00U);
+      }
+      break;
+
+    /* Read the FLASH statistics */
+    case SPECIAL_CMD_FLASH_STATS:
+      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+      {
+        status = OPENBL_FLASH_GetStatistics(SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1, data);
+
+        if (status == SUCCESS)
+        {
+          OPENBL_USART_SendSpecialCmdResponse(data, FLASH_STATS_SIZE, ACK_BYTE);
+        }
+        else
+        {
+          OPENBL_USART_SendSpecialCmdResponse(NULL, 0U, NACK_BYTE);
+        }
+      }
+      else
+      {
+        /* Send NULL status size */
+        OPENBL_USART_SendByte(0x00U);
+        OPENBL_USART_SendByte(0x00U);
+      }
+      break;
+
     /* Unknown command opcode */
     default:
       if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
@@ -227,3 +1071,42 @@ void OPENBL_USART_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *SpecialCmd)
       break;
   }
 }
+
+/**
+  * @brief  Handle USART interrupt request.
+  * @retval None.
+  */
+#if defined (__ICCARM__)
+__ramfunc void OPENBL_USART_IRQHandler(void)
+#else
+__attribute__((section(".ramfunc"))) void OPENBL_USART_IRQHandler(void)
+#endif /* (__ICCARM__) */
+{
+  /* The idle line notifies the end of a frame that does not fill half of the ring buffer */
+  if ((USARTx->ISR & USART_ISR_IDLE) != 0U)
+  {
+    USARTx->ICR = USART_ICR_IDLECF;
+
+    UsartRxEvent = 1U;
+
+    OPENBL_USART_CheckRts();
+  }
+}
+
+/**
+  * @brief  Handle USART receive DMA interrupt request.
+  * @retval None.
+  */
+#if defined (__ICCARM__)
+__ramfunc void OPENBL_USART_DMA_IRQHandler(void)
+#else
+__attribute__((section(".ramfunc"))) void OPENBL_USART_DMA_IRQHandler(void)
+#endif /* (__ICCARM__) */
+{
+  /* Half or complete ring buffer filled */
+  USARTx_RX_DMA_ClearFlag_GI();
+
+  UsartRxEvent = 1U;
+
+  OPENBL_USART_CheckRts();
+}
@@ -37,8 +37,12 @@ void OPENBL_USART_DeInit(void);
 uint8_t OPENBL_USART_ProtocolDetection(void);
 uint8_t OPENBL_USART_GetCommandOpcode(void);
 uint8_t OPENBL_USART_ReadByte(void);
+void OPENBL_USART_ReadBytes(uint8_t *pBuffer, uint32_t Length);
 void OPENBL_USART_SendByte(uint8_t Byte);
+void OPENBL_USART_SendBytes(uint8_t *pBuffer, uint32_t Length);
 void OPENBL_USART_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *Frame);
+void OPENBL_USART_IRQHandler(void);
+void OPENBL_USART_DMA_IRQHandler(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,155 @@
+/**
+  ******************************************************************************
+  * @file    window_interface.c
+  * @author  MCD Application Team
+  * @brief   Contains windowed write functions
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "platform.h"
+#include "openbl_mem.h"
+#include "app_openbootloader.h"
+#include "common_interface.h"
+#include "flash_interface.h"
+#include "window_interface.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static uint32_t Window_Address = 0U;
+static uint32_t Window_Area = AREA_ERROR;
+static uint32_t Window_AckInterval = 1U;
+static uint32_t Window_Unacknowledged = 0U;
+static uint8_t Window_Sequence = 0U;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Start a windowed write requested by the host.
+  * @param  pData The request, the start address (4 bytes, LSB first) followed by the number of
+  *         packets that the host keeps in flight.
+  * @param  DataLength The length of the request, must be 5.
+  * @param  MaxPackets The maximum number of packets in flight supported by the interface.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: The windowed write is started, the first packet sequence number is 0
+  *          - ERROR:   The request is not valid
+  */
+ErrorStatus OPENBL_WINDOW_Start(uint8_t *pData, uint32_t DataLength, uint32_t MaxPackets)
+{
+  uint32_t address;
+  uint32_t area;
+  ErrorStatus status = ERROR;
+
+  if ((DataLength == 5U) && (pData[4] != 0U) && (pData[4] <= MaxPackets))
+  {
+    address = (uint32_t)pData[0] | ((uint32_t)pData[1] << 8U) | ((uint32_t)pData[2] << 16U)
+              | ((uint32_t)pData[3] << 24U);
+    area    = OPENBL_MEM_GetAddressArea(address);
+
+    if ((Common_GetProtectionStatus() == RESET) && ((area == FLASH_AREA) || (area == RAM_AREA)))
+    {
+      Window_Address        = address;
+      Window_Area           = area;
+      Window_Sequence       = 0U;
+      Window_Unacknowledged = 0U;
+
+      /* The host is acknowledged twice per window so that it never waits for a full window */
+      Window_AckInterval = ((uint32_t)pData[4] + 1U) / 2U;
+
+      status = SUCCESS;
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Write the data of a windowed write packet.
+  * @param  Sequence The packet sequence number, it must be the next expected one.
+  * @param  pData Pointer to the packet data.
+  * @param  DataLength The length of the packet data, up to WINDOW_PACKET_SIZE.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: The data is written at the address following the previous packet
+  *          - ERROR:   The packet is out of sequence or its data is outside of the start memory area
+  */
+ErrorStatus OPENBL_WINDOW_Write(uint8_t Sequence, uint8_t *pData, uint32_t DataLength)
+{
+  ErrorStatus status = ERROR;
+
+  if ((Sequence == Window_Sequence) && (DataLength != 0U) && (DataLength <= WINDOW_PACKET_SIZE)
+      && (OPENBL_MEM_GetAddressArea(Window_Address + DataLength - 1U) == Window_Area))
+  {
+    OPENBL_MEM_Write(Window_Address, pData, DataLength);
+
+    Window_Address += DataLength;
+    Window_Sequence++;
+    Window_Unacknowledged++;
+
+    status = SUCCESS;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  End a windowed write.
+  * @param  Sequence The sequence number of the end packet, it must be the next expected one.
+  * @retval Returns SUCCESS if no packet is missing and the data is programmed else returns ERROR.
+  */
+ErrorStatus OPENBL_WINDOW_End(uint8_t Sequence)
+{
+  ErrorStatus status;
+
+  /* Program the staged FLASH data so that the written data can be checked */
+  status = OPENBL_FLASH_Flush();
+
+  if (Sequence != Window_Sequence)
+  {
+    status = ERROR;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Get the sequence number of the next expected packet.
+  * @note   It is the first failed sequence number reported to the host on error.
+  * @retval Returns the sequence number.
+  */
+uint8_t OPENBL_WINDOW_GetSequence(void)
+{
+  return Window_Sequence;
+}
+
+/**
+  * @brief  Check whether the written packets must be acknowledged.
+  * @note   The acknowledge is cumulative, it carries the sequence number of the last written packet.
+  * @retval Returns SET if an acknowledge must be sent else returns RESET.
+  */
+FlagStatus OPENBL_WINDOW_IsAckRequired(void)
+{
+  FlagStatus status = RESET;
+
+  if (Window_Unacknowledged >= Window_AckInterval)
+  {
+    Window_Unacknowledged = 0U;
+
+    status = SET;
+  }
+
+  return status;
+}
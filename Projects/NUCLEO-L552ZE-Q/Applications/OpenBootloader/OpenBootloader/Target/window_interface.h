@@ -0,0 +1,44 @@
+/**
+  ******************************************************************************
+  * @file    window_interface.h
+  * @author  MCD Application Team
+  * @brief   Header for window_interface.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef WINDOW_INTERFACE_H
+#define WINDOW_INTERFACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+#define WINDOW_PACKET_SIZE                256U  /* Maximum number of data bytes of a windowed write packet */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+ErrorStatus OPENBL_WINDOW_Start(uint8_t *pData, uint32_t DataLength, uint32_t MaxPackets);
+ErrorStatus OPENBL_WINDOW_Write(uint8_t Sequence, uint8_t *pData, uint32_t DataLength);
+ErrorStatus OPENBL_WINDOW_End(uint8_t Sequence);
+uint8_t OPENBL_WINDOW_GetSequence(void);
+FlagStatus OPENBL_WINDOW_IsAckRequired(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WINDOW_INTERFACE_H */
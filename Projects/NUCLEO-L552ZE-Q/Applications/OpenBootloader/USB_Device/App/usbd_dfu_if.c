@@ -22,6 +22,7 @@
 #include "usb_interface.h"
 #include "openbl_mem.h"
 #include "common_interface.h"
+#include "flash_interface.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -66,10 +67,14 @@ uint16_t USB_DFU_If_Init(void)
 
 /**
   * @brief  De-Initializes Memory
+  * @note   Called before the reset that leaves the DFU mode, the deferred FLASH operations
+  *         are completed so that no acknowledged data is lost.
   * @retval USBD_OK if operation is successful, MAL_FAIL else
   */
 uint16_t USB_DFU_If_DeInit(void)
 {
+  (void)OPENBL_FLASH_Flush();
+
   return 0;
 }
 
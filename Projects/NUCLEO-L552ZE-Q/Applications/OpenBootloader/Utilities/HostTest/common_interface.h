@@ -0,0 +1,40 @@
+/**
+  ******************************************************************************
+  * @file    common_interface.h
+  * @author  MCD Application Team
+  * @brief   Host replacement of the common interface header
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef COMMON_INTERFACE_H
+#define COMMON_INTERFACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "platform.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+FlagStatus Common_GetProtectionStatus(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMMON_INTERFACE_H */
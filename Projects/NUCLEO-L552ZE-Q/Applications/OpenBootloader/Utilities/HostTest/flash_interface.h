@@ -0,0 +1,41 @@
+/**
+  ******************************************************************************
+  * @file    flash_interface.h
+  * @author  MCD Application Team
+  * @brief   Host replacement of the FLASH interface header
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef FLASH_INTERFACE_H
+#define FLASH_INTERFACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "platform.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+void OPENBL_FLASH_Write(uint32_t Address, uint8_t *pData, uint32_t DataLength);
+ErrorStatus OPENBL_FLASH_Flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FLASH_INTERFACE_H */
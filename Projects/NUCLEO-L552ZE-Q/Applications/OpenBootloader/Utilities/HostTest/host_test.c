@@ -0,0 +1,354 @@
+/**
+  ******************************************************************************
+  * @file    host_test.c
+  * @author  MCD Application Team
+  * @brief   Runs the Open Bootloader stream decoders on the host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "platform.h"
+#include "openbl_mem.h"
+#include "app_openbootloader.h"
+#include "common_interface.h"
+#include "flash_interface.h"
+#include "decompress_interface.h"
+#include "patch_interface.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define HOST_SOURCE_ADDRESS               FLASH_START_ADDRESS                           /* Old image of the patch */
+#define HOST_DESTINATION_ADDRESS          (FLASH_START_ADDRESS + (FLASH_BL_SIZE / 2U))  /* Inactive bank */
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE               MAP_FIXED
+#endif /* MAP_FIXED_NOREPLACE */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static uint8_t *Host_Flash = NULL;
+static FlagStatus Host_WriteError = RESET;
+
+/* Private function prototypes -----------------------------------------------*/
+static ErrorStatus HOST_FlashInit(void);
+static uint8_t *HOST_ReadFile(const char *pName, uint32_t *pLength);
+static ErrorStatus HOST_WriteFile(const char *pName, uint8_t *pData, uint32_t DataLength);
+static ErrorStatus HOST_Decompress(uint8_t *pStream, uint32_t StreamLength, uint32_t ChunkSize, uint32_t *pLength);
+static ErrorStatus HOST_Patch(uint32_t OldLength, uint8_t *pStream, uint32_t StreamLength, uint32_t ChunkSize,
+                              uint32_t *pLength);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Map the simulated FLASH memory at its device address, erased.
+  * @note   The decoders access the FLASH through 32-bit addresses, so the memory must be mapped
+  *         at the same address as on the device.
+  * @retval Returns SUCCESS if the memory is mapped else returns ERROR.
+  */
+static ErrorStatus HOST_FlashInit(void)
+{
+  ErrorStatus status = SUCCESS;
+  void *p_memory;
+
+  p_memory = mmap((void *)(uintptr_t)FLASH_START_ADDRESS, FLASH_BL_SIZE, (PROT_READ | PROT_WRITE),
+                  (MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE), -1, 0);
+
+  if (p_memory != (void *)(uintptr_t)FLASH_START_ADDRESS)
+  {
+    status = ERROR;
+  }
+  else
+  {
+    Host_Flash = (uint8_t *)p_memory;
+    memset(Host_Flash, 0xFF, FLASH_BL_SIZE);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Read a whole file.
+  * @param  pName The name of the file.
+  * @param  pLength Pointer to the length of the file.
+  * @retval Returns the allocated content of the file, NULL on error.
+  */
+static uint8_t *HOST_ReadFile(const char *pName, uint32_t *pLength)
+{
+  FILE *p_file;
+  long length;
+  uint8_t *p_data = NULL;
+
+  p_file = fopen(pName, "rb");
+
+  if (p_file != NULL)
+  {
+    if ((fseek(p_file, 0L, SEEK_END) == 0) && ((length = ftell(p_file)) >= 0L) && (fseek(p_file, 0L, SEEK_SET) == 0))
+    {
+      /* One more byte so that an empty file is not a NULL allocation */
+      p_data = (uint8_t *)malloc((size_t)length + 1U);
+
+      if ((p_data != NULL) && (fread(p_data, 1U, (size_t)length, p_file) == (size_t)length))
+      {
+        *pLength = (uint32_t)length;
+      }
+      else
+      {
+        free(p_data);
+        p_data = NULL;
+      }
+    }
+
+    fclose(p_file);
+  }
+
+  return p_data;
+}
+
+/**
+  * @brief  Write a whole file.
+  * @param  pName The name of the file.
+  * @param  pData The content of the file.
+  * @param  DataLength The length of the content.
+  * @retval Returns SUCCESS if the file is written else returns ERROR.
+  */
+static ErrorStatus HOST_WriteFile(const char *pName, uint8_t *pData, uint32_t DataLength)
+{
+  FILE *p_file;
+  ErrorStatus status = ERROR;
+
+  p_file = fopen(pName, "wb");
+
+  if (p_file != NULL)
+  {
+    if (fwrite(pData, 1U, DataLength, p_file) == DataLength)
+    {
+      status = SUCCESS;
+    }
+
+    if (fclose(p_file) != 0)
+    {
+      status = ERROR;
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Write a compressed stream in the simulated FLASH as the special command does.
+  * @param  pStream The compressed stream.
+  * @param  StreamLength The length of the compressed stream.
+  * @param  ChunkSize The size of the chunks carried by the extended special commands.
+  * @param  pLength Pointer to the number of decompressed bytes.
+  * @retval Returns SUCCESS if the stream is decompressed else returns ERROR.
+  */
+static ErrorStatus HOST_Decompress(uint8_t *pStream, uint32_t StreamLength, uint32_t ChunkSize, uint32_t *pLength)
+{
+  uint8_t request[5];
+  uint32_t offset;
+  uint32_t length;
+  ErrorStatus status;
+
+  request[0] = DECOMPRESS_CMD_START;
+  request[1] = (uint8_t)(HOST_DESTINATION_ADDRESS & 0xFFU);
+  request[2] = (uint8_t)((HOST_DESTINATION_ADDRESS >> 8U) & 0xFFU);
+  request[3] = (uint8_t)((HOST_DESTINATION_ADDRESS >> 16U) & 0xFFU);
+  request[4] = (uint8_t)((HOST_DESTINATION_ADDRESS >> 24U) & 0xFFU);
+
+  status = OPENBL_DECOMPRESS_Control(request, 5U, pLength);
+
+  for (offset = 0U; (offset < StreamLength) && (status == SUCCESS); offset += length)
+  {
+    length = ((StreamLength - offset) > ChunkSize) ? ChunkSize : (StreamLength - offset);
+    status = OPENBL_DECOMPRESS_Feed(&pStream[offset], length);
+  }
+
+  if (status == SUCCESS)
+  {
+    request[0] = DECOMPRESS_CMD_END;
+    status     = OPENBL_DECOMPRESS_Control(request, 1U, pLength);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Apply a patch to the old image of the simulated FLASH as the special command does.
+  * @note   The old image is at HOST_SOURCE_ADDRESS and the new image is written in the inactive bank.
+  * @param  OldLength The length of the old image.
+  * @param  pStream The patch.
+  * @param  StreamLength The length of the patch.
+  * @param  ChunkSize The size of the chunks carried by the extended special commands.
+  * @param  pLength Pointer to the length of the new image.
+  * @retval Returns SUCCESS if the patch is applied else returns ERROR.
+  */
+static ErrorStatus HOST_Patch(uint32_t OldLength, uint8_t *pStream, uint32_t StreamLength, uint32_t ChunkSize,
+                              uint32_t *pLength)
+{
+  uint8_t request[13];
+  uint32_t offset;
+  uint32_t length;
+  uint32_t word[3];
+  ErrorStatus status;
+
+  word[0] = HOST_SOURCE_ADDRESS;
+  word[1] = OldLength;
+  word[2] = HOST_DESTINATION_ADDRESS;
+
+  request[0] = PATCH_CMD_START;
+
+  for (offset = 0U; offset < 12U; offset++)
+  {
+    request[1U + offset] = (uint8_t)((word[offset / 4U] >> (8U * (offset % 4U))) & 0xFFU);
+  }
+
+  status = OPENBL_PATCH_Control(request, 13U, pLength);
+
+  for (offset = 0U; (offset < StreamLength) && (status == SUCCESS); offset += length)
+  {
+    length = ((StreamLength - offset) > ChunkSize) ? ChunkSize : (StreamLength - offset);
+    status = OPENBL_PATCH_Feed(&pStream[offset], length);
+  }
+
+  if (status == SUCCESS)
+  {
+    request[0] = PATCH_CMD_END;
+    status     = OPENBL_PATCH_Control(request, 1U, pLength);
+  }
+
+  return status;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Return the memory area of an address, only the FLASH is simulated.
+  * @param  Address The address.
+  * @retval FLASH_AREA or AREA_ERROR.
+  */
+uint32_t OPENBL_MEM_GetAddressArea(uint32_t Address)
+{
+  return ((Address >= FLASH_START_ADDRESS) && (Address < FLASH_END_ADDRESS)) ? FLASH_AREA : AREA_ERROR;
+}
+
+/**
+  * @brief  Return the readout protection status, the simulated device is not protected.
+  * @retval RESET.
+  */
+FlagStatus Common_GetProtectionStatus(void)
+{
+  return RESET;
+}
+
+/**
+  * @brief  Write data in the simulated FLASH.
+  * @note   As on the device, the written bytes must be inside the FLASH and erased.
+  * @param  Address The address where that data will be written.
+  * @param  pData The data to be written.
+  * @param  DataLength The length of the data to be written.
+  * @retval None.
+  */
+void OPENBL_FLASH_Write(uint32_t Address, uint8_t *pData, uint32_t DataLength)
+{
+  uint32_t index;
+
+  if ((Address < FLASH_START_ADDRESS) || (DataLength > (FLASH_END_ADDRESS - Address)))
+  {
+    Host_WriteError = SET;
+  }
+  else
+  {
+    for (index = 0U; index < DataLength; index++)
+    {
+      if (Host_Flash[Address - FLASH_START_ADDRESS + index] != 0xFFU)
+      {
+        Host_WriteError = SET;
+      }
+
+      Host_Flash[Address - FLASH_START_ADDRESS + index] = pData[index];
+    }
+  }
+}
+
+/**
+  * @brief  Complete the simulated FLASH operations and report the write errors.
+  * @retval Returns SUCCESS if all the data is written else returns ERROR.
+  */
+ErrorStatus OPENBL_FLASH_Flush(void)
+{
+  return (Host_WriteError == RESET) ? SUCCESS : ERROR;
+}
+
+/**
+  * @brief  Run a decoder on a stream fed in chunks of a given size and save what it writes.
+  * @note   Usage: host_test decompress <stream> <chunk size> <output>
+  *                host_test patch <old image> <patch> <chunk size> <output>
+  * @param  argc Number of arguments.
+  * @param  argv Arguments.
+  * @retval 0 on success, 1 on error.
+  */
+int main(int argc, char *argv[])
+{
+  uint8_t *p_old = NULL;
+  uint8_t *p_stream = NULL;
+  uint32_t old_length = 0U;
+  uint32_t stream_length = 0U;
+  uint32_t chunk_size = 0U;
+  uint32_t length = 0U;
+  ErrorStatus status = ERROR;
+
+  if ((argc == 5) && (strcmp(argv[1], "decompress") == 0) && (HOST_FlashInit() == SUCCESS))
+  {
+    p_stream   = HOST_ReadFile(argv[2], &stream_length);
+    chunk_size = (uint32_t)strtoul(argv[3], NULL, 0);
+
+    if ((p_stream != NULL) && (chunk_size != 0U))
+    {
+      status = HOST_Decompress(p_stream, stream_length, chunk_size, &length);
+    }
+  }
+  else if ((argc == 6) && (strcmp(argv[1], "patch") == 0) && (HOST_FlashInit() == SUCCESS))
+  {
+    p_old      = HOST_ReadFile(argv[2], &old_length);
+    p_stream   = HOST_ReadFile(argv[3], &stream_length);
+    chunk_size = (uint32_t)strtoul(argv[4], NULL, 0);
+
+    /* The old image is already programmed in the active bank */
+    if ((p_old != NULL) && (p_stream != NULL) && (chunk_size != 0U)
+        && (old_length <= (HOST_DESTINATION_ADDRESS - HOST_SOURCE_ADDRESS)))
+    {
+      memcpy(&Host_Flash[HOST_SOURCE_ADDRESS - FLASH_START_ADDRESS], p_old, old_length);
+
+      status = HOST_Patch(old_length, p_stream, stream_length, chunk_size, &length);
+    }
+  }
+  else
+  {
+    fprintf(stderr, "usage: %s decompress <stream> <chunk size> <output>\n", argv[0]);
+    fprintf(stderr, "       %s patch <old image> <patch> <chunk size> <output>\n", argv[0]);
+  }
+
+  if (status == SUCCESS)
+  {
+    status = HOST_WriteFile(argv[argc - 1], &Host_Flash[HOST_DESTINATION_ADDRESS - FLASH_START_ADDRESS], length);
+  }
+
+  free(p_old);
+  free(p_stream);
+
+  return (status == SUCCESS) ? 0 : 1;
+}
@@ -0,0 +1,40 @@
+/**
+  ******************************************************************************
+  * @file    openbl_mem.h
+  * @author  MCD Application Team
+  * @brief   Host replacement of the Open Bootloader memory header
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OPENBL_MEM_H
+#define OPENBL_MEM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "platform.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+uint32_t OPENBL_MEM_GetAddressArea(uint32_t Address);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OPENBL_MEM_H */
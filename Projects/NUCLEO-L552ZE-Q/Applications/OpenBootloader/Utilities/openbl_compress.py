@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+# ******************************************************************************
+# @file    openbl_compress.py
+# @author  MCD Application Team
+# @brief   Host encoder of the SPECIAL_CMD_DECOMPRESS stream (heatshrink format)
+# ******************************************************************************
+# @attention
+#
+# Copyright (c) 2022 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+# ******************************************************************************
+"""Compress an image for the SPECIAL_CMD_DECOMPRESS special command.
+
+The stream has the heatshrink format: each item starts with a tag bit, 1 is
+followed by a literal byte and 0 by a back-reference made of the offset minus
+one on WINDOW_BITS bits and of the length minus one on LOOKAHEAD_BITS bits.
+The bits are written MSB first and the last byte is padded with 0 bits.
+As on the device, the window is initially filled with 0x00 bytes.
+
+WINDOW_BITS and LOOKAHEAD_BITS must match DECOMPRESS_WINDOW_BITS and
+DECOMPRESS_LOOKAHEAD_BITS in openbootloader_conf.h.
+"""
+
+import argparse
+import sys
+
+WINDOW_BITS = 10
+LOOKAHEAD_BITS = 4
+
+# Number of candidate positions compared for each match search
+MAX_CANDIDATES = 256
+
+
+class BitWriter:
+    """Pack bits MSB first."""
+
+    def __init__(self):
+        self.data = bytearray()
+        self.value = 0
+        self.count = 0
+
+    def put(self, value, bits):
+        for shift in range(bits - 1, -1, -1):
+            self.value = (self.value << 1) | ((value >> shift) & 1)
+            self.count += 1
+
+            if self.count == 8:
+                self.data.append(self.value)
+                self.value = 0
+                self.count = 0
+
+    def flush(self):
+        if self.count != 0:
+            self.data.append(self.value << (8 - self.count))
+            self.value = 0
+            self.count = 0
+
+        return bytes(self.data)
+
+
+def compress(data, window_bits=WINDOW_BITS, lookahead_bits=LOOKAHEAD_BITS):
+    """Return the compressed stream of data."""
+    window = 1 << window_bits
+    max_length = 1 << lookahead_bits
+    backref_bits = 1 + window_bits + lookahead_bits
+
+    # The initial window content is part of the searched buffer
+    buffer = bytes(window) + bytes(data)
+    chains = {}
+    writer = BitWriter()
+
+    def insert(position):
+        if position + 1 < len(buffer):
+            chains.setdefault(buffer[position:position + 2], []).append(position)
+
+    for position in range(window):
+        insert(position)
+
+    position = window
+
+    while position < len(buffer):
+        best_length = 0
+        best_offset = 0
+        limit = min(max_length, len(buffer) - position)
+
+        for candidate in reversed(chains.get(buffer[position:position + 2], [])[-MAX_CANDIDATES:]):
+            offset = position - candidate
+
+            if offset > window:
+                break
+
+            # The reference can overlap the bytes being copied
+            length = 0
+
+            while (length < limit) and (buffer[candidate + length] == buffer[position + length]):
+                length += 1
+
+            if length > best_length:
+                best_length = length
+                best_offset = offset
+
+                if length == limit:
+                    break
+
+        # A back-reference is only used when it is shorter than the literals
+        if best_length * 9 > backref_bits:
+            writer.put(0, 1)
+            writer.put(best_offset - 1, window_bits)
+            writer.put(best_length - 1, lookahead_bits)
+        else:
+            best_length = 1
+            writer.put(1, 1)
+            writer.put(buffer[position], 8)
+
+        for index in range(position, position + best_length):
+            insert(index)
+
+        position += best_length
+
+    return writer.flush()
+
+
+def decompress(stream, window_bits=WINDOW_BITS, lookahead_bits=LOOKAHEAD_BITS):
+    """Return the data of a compressed stream, as decompressed by the device."""
+    window = 1 << window_bits
+    output = bytearray(window)
+    bits = []
+
+    for byte in stream:
+        bits.extend((byte >> shift) & 1 for shift in range(7, -1, -1))
+
+    def get(position, count):
+        value = 0
+
+        for bit in bits[position:position + count]:
+            value = (value << 1) | bit
+
+        return value
+
+    position = 0
+
+    while True:
+        if (position < len(bits)) and (bits[position] == 1):
+            if position + 9 > len(bits):
+                break
+
+            output.append(get(position + 1, 8))
+            position += 9
+        else:
+            if position + 1 + window_bits + lookahead_bits > len(bits):
+                break
+
+            offset = get(position + 1, window_bits) + 1
+            length = get(position + 1 + window_bits, lookahead_bits) + 1
+
+            for _ in range(length):
+                output.append(output[len(output) - offset])
+
+            position += 1 + window_bits + lookahead_bits
+
+    return bytes(output[window:])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("mode", choices=["compress", "decompress"])
+    parser.add_argument("input", help="input file")
+    parser.add_argument("output", help="output file")
+    parser.add_argument("--window-bits", type=int, default=WINDOW_BITS)
+    parser.add_argument("--lookahead-bits", type=int, default=LOOKAHEAD_BITS)
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as file:
+        data = file.read()
+
+    if args.mode == "compress":
+        result = compress(data, args.window_bits, args.lookahead_bits)
+
+        if decompress(result, args.window_bits, args.lookahead_bits) != data:
+            sys.exit("error: the compressed stream does not decompress to the input")
+
+        print("%d bytes compressed to %d bytes (%.1f%%)"
+              % (len(data), len(result), (100.0 * len(result) / len(data)) if data else 0.0))
+    else:
+        result = decompress(data, args.window_bits, args.lookahead_bits)
+
+    with open(args.output, "wb") as file:
+        file.write(result)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+# ******************************************************************************
+# @file    openbl_patch.py
+# @author  MCD Application Team
+# @brief   Host generator of the SPECIAL_CMD_PATCH stream (bsdiff-like format)
+# ******************************************************************************
+# @attention
+#
+# Copyright (c) 2022 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+# ******************************************************************************
+"""Build the patch of an image for the SPECIAL_CMD_PATCH special command.
+
+The patch has the bsdiff layout without compression, a sequence of blocks made
+of a control record followed by the diff and the extra bytes:
+  - the control record is the diff length, the extra length and the signed
+    seek applied to the old image position once the block is done (4 bytes
+    each, LSB first),
+  - each diff byte is added (modulo 256) to the next old image byte to give a
+    new image byte,
+  - the extra bytes are copied to the new image.
+The old image position starts at 0.
+"""
+
+import argparse
+import struct
+import sys
+
+# Length of the exact matches looked up in the old image
+SEED_LENGTH = 8
+
+# Shortest exact match used as a diff region
+MIN_MATCH = 16
+
+# Largest gap between two matches at the same offset merged in one diff region
+MAX_GAP = 64
+
+# Number of candidate positions compared for each match search
+MAX_CANDIDATES = 32
+
+
+def find_matches(old, new):
+    """Return the exact matches as (new start, old start, length), in new image order."""
+    index = {}
+
+    for position in range(len(old) - SEED_LENGTH + 1):
+        index.setdefault(old[position:position + SEED_LENGTH], []).append(position)
+
+    matches = []
+    delta = 0
+    position = 0
+
+    while position + SEED_LENGTH <= len(new):
+        best_length = 0
+        best_old = 0
+
+        for candidate in index.get(new[position:position + SEED_LENGTH], [])[:MAX_CANDIDATES]:
+            length = SEED_LENGTH
+
+            while ((position + length < len(new)) and (candidate + length < len(old))
+                   and (new[position + length] == old[candidate + length])):
+                length += 1
+
+            # Keep the current alignment on equal lengths, it merges with the previous match
+            if (length > best_length) or ((length == best_length) and (candidate - position == delta)):
+                best_length = length
+                best_old = candidate
+
+        if best_length >= MIN_MATCH:
+            matches.append((position, best_old, best_length))
+            delta = best_old - position
+            position += best_length
+        else:
+            position += 1
+
+    return matches
+
+
+def extend(old, new, new_start, old_start, limit, step):
+    """Return the length of the approximate extension of a match, forward (step 1) or backward (step -1).
+
+    As bsdiff does, the extension keeps the length with the most matching bytes minus mismatching ones.
+    """
+    best = 0
+    score = 0
+    best_score = 0
+
+    for length in range(limit):
+        offset = length if step > 0 else -1 - length
+
+        if (old_start + offset < 0) or (old_start + offset >= len(old)):
+            break
+
+        score += 1 if new[new_start + offset] == old[old_start + offset] else -1
+
+        if score > best_score:
+            best_score = score
+            best = length + 1
+
+    return best
+
+
+def find_regions(old, new):
+    """Return the diff regions as [new start, new end, old start], in new image order."""
+    regions = []
+
+    for new_start, old_start, length in find_matches(old, new):
+        if (regions and (regions[-1][2] - regions[-1][0] == old_start - new_start)
+                and (new_start - regions[-1][1] <= MAX_GAP)):
+            regions[-1][1] = new_start + length
+        else:
+            regions.append([new_start, new_start + length, old_start])
+
+    # Extend the regions over the nearby bytes that mostly match, as bsdiff does
+    for index, region in enumerate(regions):
+        previous_end = regions[index - 1][1] if index > 0 else 0
+        next_start = regions[index + 1][0] if index + 1 < len(regions) else len(new)
+
+        forward = extend(old, new, region[1], region[2] + region[1] - region[0], next_start - region[1], 1)
+        region[1] += forward
+
+        backward = extend(old, new, region[0], region[2], region[0] - previous_end, -1)
+        region[0] -= backward
+        region[2] -= backward
+
+    return regions
+
+
+def make_patch(old, new):
+    """Return the patch building new from old."""
+    blocks = []
+    regions = find_regions(old, new)
+
+    if not regions:
+        if new:
+            blocks.append((b"", new, 0))
+    else:
+        if (regions[0][0] != 0) or (regions[0][2] != 0):
+            blocks.append((b"", new[:regions[0][0]], regions[0][2]))
+
+        for index, (new_start, new_end, old_start) in enumerate(regions):
+            diff = bytes((new[new_start + offset] - old[old_start + offset]) & 0xFF
+                         for offset in range(new_end - new_start))
+
+            if index + 1 < len(regions):
+                extra = new[new_end:regions[index + 1][0]]
+                seek = regions[index + 1][2] - (old_start + len(diff))
+            else:
+                extra = new[new_end:]
+                seek = 0
+
+            blocks.append((diff, extra, seek))
+
+    patch = bytearray()
+
+    for diff, extra, seek in blocks:
+        patch += struct.pack("<IIi", len(diff), len(extra), seek)
+        patch += diff
+        patch += extra
+
+    return bytes(patch)
+
+
+def apply_patch(old, patch):
+    """Return the new image of a patch, as applied by the device, or None if the patch is not valid."""
+    new = bytearray()
+    position = 0
+    old_position = 0
+
+    while position < len(patch):
+        if position + 12 > len(patch):
+            return None
+
+        diff_length, extra_length, seek = struct.unpack_from("<IIi", patch, position)
+        position += 12
+
+        if ((position + diff_length + extra_length > len(patch))
+                or (old_position + diff_length > len(old))):
+            return None
+
+        for offset in range(diff_length):
+            new.append((patch[position + offset] + old[old_position + offset]) & 0xFF)
+
+        position += diff_length
+        old_position += diff_length
+
+        new += patch[position:position + extra_length]
+        position += extra_length
+
+        old_position = (old_position + seek) & 0xFFFFFFFF
+
+    return bytes(new)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("mode", choices=["diff", "apply"])
+    parser.add_argument("old", help="image in FLASH")
+    parser.add_argument("input", help="new image to diff or patch to apply")
+    parser.add_argument("output", help="patch or new image")
+    args = parser.parse_args()
+
+    with open(args.old, "rb") as file:
+        old = file.read()
+
+    with open(args.input, "rb") as file:
+        data = file.read()
+
+    if args.mode == "diff":
+        result = make_patch(old, data)
+
+        if apply_patch(old, result) != data:
+            sys.exit("error: the patch does not build the new image")
+
+        print("%d bytes image patched with %d bytes (%.1f%%)"
+              % (len(data), len(result), (100.0 * len(result) / len(data)) if data else 0.0))
+    else:
+        result = apply_patch(old, data)
+
+        if result is None:
+            sys.exit("error: the patch is not valid for this image")
+
+    with open(args.output, "wb") as file:
+        file.write(result)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,278 @@
+#!/usr/bin/env python3
+# ******************************************************************************
+# @file    openbl_test.py
+# @author  MCD Application Team
+# @brief   Round-trip tests of the Open Bootloader stream decoders on the host
+# ******************************************************************************
+# @attention
+#
+# Copyright (c) 2022 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+# ******************************************************************************
+"""Run the Open Bootloader stream decoders on the host against the test vectors.
+
+The decoder sources of OpenBootloader/Target are built with the host compiler
+and the stub headers of HostTest, the FLASH being simulated at its device
+address. Each compressed stream and each patch of the Vectors directory is fed
+in chunks of several sizes so that the items split between two chunks are
+decoded, and the written data is compared with the expected image.
+
+Usage: openbl_test.py [--regenerate] [--image FILE ...]
+"""
+
+import argparse
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+import openbl_compress
+import openbl_patch
+
+UTILITIES_DIR = os.path.dirname(os.path.abspath(__file__))
+TARGET_DIR = os.path.join(UTILITIES_DIR, "..", "OpenBootloader", "Target")
+HOST_TEST_DIR = os.path.join(UTILITIES_DIR, "HostTest")
+VECTORS_DIR = os.path.join(UTILITIES_DIR, "Vectors")
+
+# Sizes of the chunks carried by the extended special commands
+CHUNK_SIZES = [1, 2, 3, 5, 7, 8, 9, 13, 15, 16, 64, 255, 256, 1024]
+
+# Link used for the transfer time estimates: 10 bits per byte on the USART
+BAUD_RATE = 115200
+
+
+def read_config(name):
+    """Return the value of a numeric define of openbootloader_conf.h."""
+    with open(os.path.join(TARGET_DIR, "openbootloader_conf.h")) as file:
+        match = re.search(r"#define\s+%s\s+(\d+)U" % name, file.read())
+
+    return int(match.group(1))
+
+
+def build(build_dir):
+    """Build the host test program with the decoders of the target."""
+    sources = ["decompress_interface.c", "decompress_interface.h", "patch_interface.c", "patch_interface.h",
+               "openbootloader_conf.h"]
+
+    for name in sources:
+        shutil.copy(os.path.join(TARGET_DIR, name), build_dir)
+
+    for name in os.listdir(HOST_TEST_DIR):
+        shutil.copy(os.path.join(HOST_TEST_DIR, name), build_dir)
+
+    program = os.path.join(build_dir, "host_test")
+    subprocess.check_call([os.environ.get("CC", "cc"), "-O2", "-Wall", "-Wno-int-to-pointer-cast",
+                           "-o", program] + [os.path.join(build_dir, name) for name in os.listdir(build_dir)
+                                             if name.endswith(".c")])
+
+    return program
+
+
+def run(program, mode, files, chunk_size, output):
+    """Run a decoder of the host test program, return the written data or None on error."""
+    result = subprocess.run([program, mode] + files + [str(chunk_size), output])
+
+    if result.returncode != 0:
+        return None
+
+    with open(output, "rb") as file:
+        return file.read()
+
+
+def make_decompress_vectors():
+    """Return the images of the compressed write test vectors."""
+    rng = random.Random(0x0B)
+    block = bytes(rng.getrandbits(8) for _ in range(1024))
+    text = "".join("register 0x%08X = %d\n" % (0x40000000 + (4 * (index % 97)), index % 13)
+                   for index in range(200)).encode()
+
+    return {
+        # No chunk at all, only the start and the end of the compressed write
+        "empty": b"",
+        # Back-references to the initial window and overlapping the copied bytes
+        "zeros": bytes(4096),
+        # Literals only, the stream is larger than the image
+        "random": bytes(rng.getrandbits(8) for _ in range(3000)),
+        # Typical mix of literals and back-references
+        "text": text,
+        # Back-references at the largest offset, odd length staged by the FLASH write
+        "window": block * 3 + block[:5],
+    }
+
+
+def make_patch_vectors():
+    """Return the old and new images of the patch test vectors."""
+    rng = random.Random(0x0C)
+    old = bytes(rng.getrandbits(8) for _ in range(6000))
+    edit = bytearray(old)
+
+    for position in [100, 2000, 2001, 4500]:
+        edit[position] ^= 0x5A
+
+    return {
+        # A single diff block of zeros
+        "patch_identical": (old, old),
+        # Modified bytes inside a diff block
+        "patch_edit": (old, bytes(edit)),
+        # Extra bytes and a positive seek
+        "patch_insert": (old, old[:1000] + bytes(rng.getrandbits(8) for _ in range(37)) + old[1000:]),
+        # Part of the old image skipped
+        "patch_shrink": (old, old[:1500] + old[2500:]),
+        # Extra bytes at the end of the new image
+        "patch_grow": (old, old + bytes(rng.getrandbits(8) for _ in range(700))),
+        # Negative seek to the start of the old image
+        "patch_reorder": (old, old[3000:] + old[:3000]),
+    }
+
+
+def regenerate():
+    """Write the test vectors and their encoded streams."""
+    os.makedirs(VECTORS_DIR, exist_ok=True)
+
+    for name, image in make_decompress_vectors().items():
+        with open(os.path.join(VECTORS_DIR, name + ".bin"), "wb") as file:
+            file.write(image)
+
+        with open(os.path.join(VECTORS_DIR, name + ".hs"), "wb") as file:
+            file.write(openbl_compress.compress(image))
+
+    for name, (old, new) in make_patch_vectors().items():
+        for extension, data in [(".old", old), (".new", new), (".patch", openbl_patch.make_patch(old, new))]:
+            with open(os.path.join(VECTORS_DIR, name + extension), "wb") as file:
+                file.write(data)
+
+
+def load(name, extension):
+    with open(os.path.join(VECTORS_DIR, name + extension), "rb") as file:
+        return file.read()
+
+
+def test_decompress(program, work_dir, images):
+    """Check the compressed write of the vectors and of the given images."""
+    window_bits = read_config("DECOMPRESS_WINDOW_BITS")
+    lookahead_bits = read_config("DECOMPRESS_LOOKAHEAD_BITS")
+    errors = 0
+    cases = []
+
+    for name in sorted(file[:-3] for file in os.listdir(VECTORS_DIR) if file.endswith(".hs")):
+        cases.append((name, load(name, ".bin"), load(name, ".hs")))
+
+    for path in images:
+        with open(path, "rb") as file:
+            image = file.read()
+
+        cases.append((os.path.basename(path), image,
+                      openbl_compress.compress(image, window_bits, lookahead_bits)))
+
+    print("%-16s %9s %11s %7s %14s %14s" % ("Image", "Size", "Compressed", "Ratio",
+                                            "Raw at %d" % BAUD_RATE, "Compressed"))
+
+    for name, image, stream in cases:
+        stream_path = os.path.join(work_dir, name + ".hs")
+        output_path = os.path.join(work_dir, name + ".out")
+
+        with open(stream_path, "wb") as file:
+            file.write(stream)
+
+        if openbl_compress.decompress(stream, window_bits, lookahead_bits) != image:
+            print("%s: the vector stream does not decompress to the image" % name)
+            errors += 1
+
+        if openbl_compress.decompress(openbl_compress.compress(image, window_bits, lookahead_bits),
+                                      window_bits, lookahead_bits) != image:
+            print("%s: the encoder round trip fails" % name)
+            errors += 1
+
+        for chunk_size in CHUNK_SIZES:
+            if run(program, "decompress", [stream_path], chunk_size, output_path) != image:
+                print("%s: wrong data written with chunks of %d bytes" % (name, chunk_size))
+                errors += 1
+
+        print("%-16s %9d %11d %6.1f%% %12.3f s %12.3f s"
+              % (name, len(image), len(stream), (100.0 * len(stream) / len(image)) if image else 0.0,
+                 len(image) * 10.0 / BAUD_RATE, len(stream) * 10.0 / BAUD_RATE))
+
+    return errors
+
+
+def test_patch(program, work_dir):
+    """Check the patch of the vectors, and that a truncated patch is rejected."""
+    errors = 0
+
+    print("%-16s %9s %9s %11s %7s %14s %14s" % ("Patch", "Old size", "New size", "Patch size", "Ratio",
+                                                "Raw at %d" % BAUD_RATE, "Patch"))
+
+    for name in sorted(file[:-6] for file in os.listdir(VECTORS_DIR) if file.endswith(".patch")):
+        old = load(name, ".old")
+        new = load(name, ".new")
+        patch = load(name, ".patch")
+        old_path = os.path.join(VECTORS_DIR, name + ".old")
+        patch_path = os.path.join(work_dir, name + ".patch")
+        output_path = os.path.join(work_dir, name + ".out")
+
+        if openbl_patch.apply_patch(old, patch) != new:
+            print("%s: the vector patch does not build the new image" % name)
+            errors += 1
+
+        if openbl_patch.apply_patch(old, openbl_patch.make_patch(old, new)) != new:
+            print("%s: the generator round trip fails" % name)
+            errors += 1
+
+        with open(patch_path, "wb") as file:
+            file.write(patch)
+
+        for chunk_size in CHUNK_SIZES:
+            if run(program, "patch", [old_path, patch_path], chunk_size, output_path) != new:
+                print("%s: wrong data written with chunks of %d bytes" % (name, chunk_size))
+                errors += 1
+
+        # A patch that does not end on a block boundary must be rejected
+        with open(patch_path, "wb") as file:
+            file.write(patch[:-1])
+
+        if patch and (run(program, "patch", [old_path, patch_path], 64, output_path) is not None):
+            print("%s: truncated patch accepted" % name)
+            errors += 1
+
+        print("%-16s %9d %9d %11d %6.1f%% %12.3f s %12.3f s"
+              % (name, len(old), len(new), len(patch), (100.0 * len(patch) / len(new)) if new else 0.0,
+                 len(new) * 10.0 / BAUD_RATE, len(patch) * 10.0 / BAUD_RATE))
+
+    return errors
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--regenerate", action="store_true", help="write the test vectors again")
+    parser.add_argument("--image", action="append", default=[], help="also compress and check this image")
+    args = parser.parse_args()
+
+    if args.regenerate:
+        regenerate()
+
+    work_dir = tempfile.mkdtemp(prefix="openbl_test_")
+
+    try:
+        build_dir = os.path.join(work_dir, "build")
+        os.mkdir(build_dir)
+        program = build(build_dir)
+
+        errors = test_decompress(program, work_dir, args.image)
+        errors += test_patch(program, work_dir)
+    finally:
+        shutil.rmtree(work_dir)
+
+    print("%d error(s)" % errors)
+    sys.exit(1 if errors else 0)
+
+
+if __name__ == "__main__":
+    main()